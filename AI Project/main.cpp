@@ -24,6 +24,7 @@ written consent of DigiPen Institute of Technology is prohibited.
 #include "Loader.h"
 #include "Camera.h"
 #include "Grid.h"
+#include "JobSystem.h"
 
 Vec2 winSize = { 1600.f, 900.f };
 float ratio = winSize.x / winSize.y;
@@ -35,6 +36,7 @@ bool canZoom = true; // disable zooming when in dropdown menus
 bool isPaused = false;
 float dt = 0.f;
 DrawMode mode = DrawMode::WALL;
+int enemyGroup = -1; // group new enemies join and goal clicks move, -1 for the shared field
 extern RepulsionConfig rConfig;
 extern PotentialConfig pConfig;
 
@@ -49,6 +51,7 @@ Factory factory;
 Grid grid(25, 50, cellSize); // this is height x width not width x height omg
 Loader loader;
 Camera camera;
+JobSystem jobs;
 
 //! temp
 bool isLMousePressed{ false }, isRMousePressed{ false };
@@ -80,19 +83,33 @@ int main()
     while (window.isOpen() && !canExit)
     {
         dt = clock.restart().asSeconds();
+
+        // hand last frame's grid changes to whoever listens
+        grid.publishChanges();
+
         sf::Event event;
 
         // if exit found, path to exit
         if (grid.isExitFound())
         {
-            grid.updateHeatMap(grid.getWorldPos(grid.exitCell->pos));
-
-            grid.CombineMaps();
-            grid.generateFlowField();
+            if (grid.hierarchicalFlowField)
+            {
+                // only the sectors the enemies walk through get solved
+                grid.setFlowFieldGoal(grid.getWorldPos(grid.exitCell->pos));
+            }
+            else
+            {
+                // solved again only when the exit or the walls changed, flow field directions
+                // are evaluated when the enemies ask for them
+                grid.updateExitField(grid.getWorldPos(grid.exitCell->pos));
+            }
 
-            // set all enemy to the target
+            // set all enemy to the target, every group follows the exit field from here
             for (Enemy* enemy : factory.getEntities<Enemy>())
+            {
+                enemy->group() = -1;
                 enemy->setTargetPos(grid.getWorldPos(grid.exitCell->pos), true);
+            }
         }
         else
         {
@@ -100,11 +117,15 @@ int main()
 
             if (rConfig.useRepulsionMap)
             {
-                // for walls
-                //grid.updateRepulsionMap(rConfig.radius, 1.f);
+                // for walls, resets the layer before the enemies add theirs
+                grid.updateRepulsionMap(rConfig.radius, 1.f);
 
                 for (Enemy* enemy : factory.getEntities<Enemy>())
-                    grid.updateRepulsionMap(grid.getGridPos(enemy->pos), rConfig.radius, 1.f);
+                    grid.updateRepulsionMap(grid.getGridPos(enemy->pos()), rConfig.radius, 1.f);
+            }
+            else
+            {
+                grid.clearRepulsionMap();
             }
 
 
@@ -114,11 +135,17 @@ int main()
             {
                 grid.updatePotentialMap();
             }
+            else
+            {
+                grid.clearPotentialMap();
+            }
 
             grid.CombineMaps();
-            grid.generateFlowField();
         }    
 
+        // groups with their own goal
+        grid.updateGroupFlowFields();
+
         while (window.pollEvent(event))
         {
             // Pass events to ImGui
@@ -164,14 +191,30 @@ int main()
                 Vec2 target = window.mapPixelToCoords(sf::Mouse::getPosition(window));
                 grid.setIntensity(grid.getGridPos(target));
                 if (mode == DrawMode::ENTITY)
-                    factory.cloneEnemyAt(target);
+                    if (Enemy *enemy = factory.cloneEnemyAt(target))
+                        enemy->group() = enemyGroup;
 
+                // shift click walks the group along a searched path, no flow field needed
+                if (!grid.isWall(grid.getGridPos(target)) && mode == DrawMode::GOAL && sf::Keyboard::isKeyPressed(sf::Keyboard::LShift))
+                {
+                    for (Enemy *enemy : factory.getEntities<Enemy>())
+                        if (enemy->group() == enemyGroup)
+                            enemy->setPath(grid.findPath(enemy->pos(), target, grid.pathMethod));
+                }
                 // move enemy to cell
-                if (!grid.isWall(grid.getGridPos(target)) && mode == DrawMode::GOAL)
+                else if (!grid.isWall(grid.getGridPos(target)) && mode == DrawMode::GOAL)
                 {
-                    // set all enemy to the target
+                    // a group gets a field of its own, solved now so its enemies can take the target
+                    if (enemyGroup >= 0)
+                    {
+                        grid.setGroupGoal(enemyGroup, target);
+                        grid.updateGroupFlowFields();
+                    }
+
+                    // set all enemy of the group to the target
                     for (Enemy *enemy : factory.getEntities<Enemy>())
-                        enemy->setTargetPos(target, true);
+                        if (enemy->group() == enemyGroup)
+                            enemy->setTargetPos(target, true);
                 }
             }
 
@@ -183,7 +226,7 @@ int main()
 
                 if (mode == DrawMode::ENTITY)
                     for (Enemy *enemy : factory.getEntities<Enemy>())
-                        if (grid.getGridPos(target) == grid.getGridPos(enemy->pos))
+                        if (grid.getGridPos(target) == grid.getGridPos(enemy->pos()))
                             factory.destroyEntity<Enemy>(enemy);
 
                 if (!grid.isWall(grid.getGridPos(target)) && mode == DrawMode::GOAL)
@@ -0,0 +1,124 @@
+//==============================================================================
+/*!
+\file		AgentStore.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the packed per type agent store
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "AgentStore.h"
+#include "Utility.h"
+
+namespace
+{
+	//! moves the last element into a row and drops the last
+	template <typename T>
+	void swapRemove(std::vector<T> &column, size_t row)
+	{
+		column[row] = column.back();
+		column.pop_back();
+	}
+}
+
+AgentHandle AgentStore::create(Agent const &agent, Entity *entity)
+{
+	std::uint32_t slot;
+
+	if (freeSlots.empty())
+	{
+		slot = static_cast<std::uint32_t>(slotRow.size());
+		slotRow.push_back(0);
+		slotGeneration.push_back(0);
+	}
+	else
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+
+	slotRow[slot] = static_cast<std::uint32_t>(owner.size());
+	rowSlot.push_back(slot);
+
+	pos.push_back(agent.pos);
+	targetPos.push_back(agent.targetPos);
+	scale.push_back(agent.scale);
+	dir.push_back(agent.dir);
+	targetDir.push_back(agent.targetDir);
+	speed.push_back(agent.speed);
+	currSpeed.push_back(agent.currSpeed);
+	transitionTime.push_back(agent.transitionTime);
+	group.push_back(agent.group);
+	followsPath.push_back(agent.followsPath);
+	shape.push_back(agent.shape);
+	color.push_back(agent.color);
+	owner.push_back(entity);
+
+	return AgentHandle{ slot, slotGeneration[slot] };
+}
+
+void AgentStore::destroy(AgentHandle handle)
+{
+	size_t row = rowOf(handle);
+
+	swapRemove(pos, row);
+	swapRemove(targetPos, row);
+	swapRemove(scale, row);
+	swapRemove(dir, row);
+	swapRemove(targetDir, row);
+	swapRemove(speed, row);
+	swapRemove(currSpeed, row);
+	swapRemove(transitionTime, row);
+	swapRemove(group, row);
+	swapRemove(followsPath, row);
+	swapRemove(shape, row);
+	swapRemove(color, row);
+	swapRemove(owner, row);
+
+	// the last agent now sits in the freed row
+	swapRemove(rowSlot, row);
+	if (row < rowSlot.size())
+		slotRow[rowSlot[row]] = static_cast<std::uint32_t>(row);
+
+	++slotGeneration[handle.slot];
+	freeSlots.push_back(handle.slot);
+}
+
+bool AgentStore::isAlive(AgentHandle handle) const
+{
+	return handle.slot < slotGeneration.size() && slotGeneration[handle.slot] == handle.generation;
+}
+
+size_t AgentStore::rowOf(AgentHandle handle) const
+{
+	crashIf(!isAlive(handle), "Agent handle is no longer alive");
+	return slotRow[handle.slot];
+}
+
+AgentHandle AgentStore::handleOf(size_t row) const
+{
+	std::uint32_t slot = rowSlot[row];
+	return AgentHandle{ slot, slotGeneration[slot] };
+}
+
+void AgentStore::reserve(size_t count)
+{
+	pos.reserve(count);
+	targetPos.reserve(count);
+	scale.reserve(count);
+	dir.reserve(count);
+	targetDir.reserve(count);
+	speed.reserve(count);
+	currSpeed.reserve(count);
+	transitionTime.reserve(count);
+	group.reserve(count);
+	followsPath.reserve(count);
+	shape.reserve(count);
+	color.reserve(count);
+	owner.reserve(count);
+	rowSlot.reserve(count);
+}
@@ -0,0 +1,90 @@
+//==============================================================================
+/*!
+\file		AgentStore.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the packed per type agent store
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef AGENTSTORE_H
+#define AGENTSTORE_H
+
+#include "Vector2D.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+
+enum Shape
+{
+	NONE,
+	CIRCLE,
+	TRIANGLE,
+	RECTANGLE,
+	MAX_SHAPES
+};
+
+class Entity;
+
+// names an agent without pointing at it. the slot stays with the agent while it lives and the generation
+// changes when the slot is reused, so a handle kept after its agent is gone is caught instead of reading another
+struct AgentHandle
+{
+	static constexpr std::uint32_t INVALID_SLOT = ~0u;
+
+	std::uint32_t slot{ INVALID_SLOT };
+	std::uint32_t generation{};
+
+	bool operator==(AgentHandle const &rhs) const { return slot == rhs.slot && generation == rhs.generation; }
+	bool operator!=(AgentHandle const &rhs) const { return !(*this == rhs); }
+};
+
+//! state of one agent, a row of the store
+struct Agent
+{
+	Vec2 pos, targetPos, scale, dir, targetDir;
+	float speed{}, currSpeed{}, transitionTime{};
+	int group{ -1 };
+	unsigned char followsPath{};
+	Shape shape{ NONE };
+	sf::Color color;
+};
+
+// the agents of one entity type, one array per field so the systems walk packed memory. removing an agent
+// moves the last one into its row, so the rows stay dense but their order changes and rows are only found through handles
+class AgentStore
+{
+	std::vector<std::uint32_t> slotRow;			// row of the agent in every slot
+	std::vector<std::uint32_t> slotGeneration;	// bumped when the slot is freed
+	std::vector<std::uint32_t> rowSlot;			// slot of the agent in every row
+	std::vector<std::uint32_t> freeSlots;
+
+public:
+
+	std::vector<Vec2> pos, targetPos, scale, dir, targetDir;
+	std::vector<float> speed, currSpeed;
+	std::vector<float> transitionTime;		// time taken to transition to new direction
+	std::vector<int> group;					// flow field group, -1 follows the shared field
+	std::vector<unsigned char> followsPath;	// steers straight at the waypoints of a searched path instead of along a flow field,
+											// not vector<bool> so rows can be referenced
+	std::vector<Shape> shape;
+	std::vector<sf::Color> color;
+	std::vector<Entity *> owner;			// entity with the rest of the agent's state
+
+	AgentHandle create(Agent const &agent, Entity *entity);
+	void destroy(AgentHandle handle);
+	bool isAlive(AgentHandle handle) const;
+
+	//! row of a live agent
+	size_t rowOf(AgentHandle handle) const;
+	AgentHandle handleOf(size_t row) const;
+
+	size_t size() const { return owner.size(); }
+	void reserve(size_t count);
+};
+
+#endif // !AGENTSTORE_H
@@ -0,0 +1,700 @@
+//==============================================================================
+/*!
+\file		Benchmark.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the benchmark functionalities
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "Benchmark.h"
+#include "FieldSolver.h"
+#include "Grid.h"
+#include "JobSystem.h"
+#include "FieldKernels.h"
+#include "LineOfSight.h"
+#include "PathFinder.h"
+#include "Separation.h"
+#include "Factory.h"
+#include "MathLib.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <queue>
+#include <random>
+
+extern JobSystem jobs;
+extern Factory factory;
+
+namespace
+{
+	// synthetic map so the benchmarks don't depend on the loaded grid
+	struct BenchMap
+	{
+		int height{}, width{};
+		std::vector<unsigned char> walls;
+		std::vector<Visibility> visibility;
+
+		BenchMap(int size, float wallChance, float unexploredChance)
+			: height(size), width(size), walls(size * size), visibility(size * size, VISIBLE)
+		{
+			std::mt19937 rng(380);
+			std::uniform_real_distribution<float> roll(0.f, 1.f);
+
+			for (int index{}; index < height * width; ++index)
+			{
+				walls[index] = roll(rng) < wallChance;
+				if (roll(rng) < unexploredChance)
+					visibility[index] = UNEXPLORED;
+			}
+		}
+
+		bool isKnownWall(int index) const { return walls[index] && visibility[index] != UNEXPLORED; }
+
+		// same neighbour rules as the heat maps in Grid
+		bool canStep(int from, int i, int j, bool isExitMap) const
+		{
+			int row = from / width + i, col = from % width + j;
+
+			if (row < 0 || row >= height || col < 0 || col >= width)
+				return false;
+
+			int index = row * width + col;
+			if (isExitMap ? isKnownWall(index) : walls[index])
+				return false;
+
+			if (i != 0 && j != 0)
+				if (isKnownWall(row * width + col - j) || isKnownWall((row - i) * width + col))
+					return false;
+
+			return true;
+		}
+	};
+
+	// the heat map relaxation as it was before the bucket queue: FIFO order and no
+	// re-queuing of improved cells (the exit map also measured the step from the target)
+	void fifoHeatMap(BenchMap const &map, std::vector<float> &dist, bool isExitMap)
+	{
+		std::vector<unsigned char> visited(dist.size(), false);
+		std::queue<int> openList;
+		int target = map.height / 2 * map.width + map.width / 2;
+
+		std::fill(dist.begin(), dist.end(), UNREACHED);
+
+		for (int index{}; index < map.height * map.width; ++index)
+			if (isExitMap ? index == target : map.visibility[index] == UNEXPLORED)
+			{
+				dist[index] = 0.f;
+				visited[index] = true;
+				openList.push(index);
+			}
+
+		while (!openList.empty())
+		{
+			int currIndex = openList.front();
+			int row = currIndex / map.width, col = currIndex % map.width;
+			openList.pop();
+
+			for (int i{ -1 }; i <= 1; ++i)
+				for (int j{ -1 }; j <= 1; ++j)
+				{
+					if ((i == 0 && j == 0) || !map.canStep(currIndex, i, j, isExitMap))
+						continue;
+
+					int neighbourIndex = (row + i) * map.width + col + j;
+					float dx = isExitMap ? (float)(row + i - target / map.width) : (float)i;
+					float dy = isExitMap ? (float)(col + j - target % map.width) : (float)j;
+					float newDistance = dist[currIndex] + std::sqrt(dx * dx + dy * dy);
+
+					if (visited[neighbourIndex])
+					{
+						if (newDistance < dist[neighbourIndex])
+							dist[neighbourIndex] = newDistance;
+					}
+					else
+					{
+						dist[neighbourIndex] = newDistance;
+						visited[neighbourIndex] = true;
+						openList.push(neighbourIndex);
+					}
+				}
+		}
+	}
+
+	// same layers as Grid::updateStepLayers, with the sources set in dist
+	void seedHeatMap(BenchMap const &map, std::vector<float> &dist,
+		std::vector<unsigned char> &canEnter, std::vector<unsigned char> &blocksCorner, bool isExitMap)
+	{
+		int target = map.height / 2 * map.width + map.width / 2;
+
+		for (int index{}; index < map.height * map.width; ++index)
+		{
+			blocksCorner[index] = map.isKnownWall(index);
+			canEnter[index] = isExitMap ? !blocksCorner[index] : !map.walls[index];
+			dist[index] = (isExitMap ? index == target : map.visibility[index] == UNEXPLORED) ? 0.f : UNREACHED;
+		}
+	}
+
+	void bucketHeatMap(BenchMap const &map, std::vector<float> &dist, BucketQueue &queue,
+		std::vector<unsigned char> &canEnter, std::vector<unsigned char> &blocksCorner, bool isExitMap)
+	{
+		seedHeatMap(map, dist, canEnter, blocksCorner, isExitMap);
+
+		for (int index{}; index < map.height * map.width; ++index)
+			if (dist[index] == 0.f)
+				queue.push(0.f, index);
+
+		solveField(map.height, map.width, canEnter, blocksCorner, dist, nullptr, queue);
+	}
+
+	void tiledHeatMap(BenchMap const &map, std::vector<float> &dist, TiledFieldSolver &solver,
+		std::vector<unsigned char> &canEnter, std::vector<unsigned char> &blocksCorner, bool isExitMap)
+	{
+		seedHeatMap(map, dist, canEnter, blocksCorner, isExitMap);
+		solver.solve(map.height, map.width, canEnter, blocksCorner, dist, nullptr, jobs);
+	}
+
+	// the combine/ normalize loops as they were before the kernels, one pass per step
+	void oldCombine(std::vector<float> const &distance, std::vector<float> const &repulsion, std::vector<float> const &potential,
+		std::vector<unsigned char> const &walls, float potentialWeight, std::vector<float> &final)
+	{
+		for (size_t index{}; index < final.size(); ++index)
+			if (!walls[index])
+				final[index] = distance[index] + repulsion[index] - potential[index] * potentialWeight;
+
+		float minFinal = std::numeric_limits<float>::max();
+		float maxFinal = -std::numeric_limits<float>::max();
+
+		for (size_t index{}; index < final.size(); ++index)
+		{
+			if (walls[index])
+				continue;
+
+			minFinal = std::min(minFinal, final[index]);
+			maxFinal = std::max(maxFinal, final[index]);
+		}
+
+		for (float &cellFinal : final)
+			cellFinal = maxFinal > minFinal ? (cellFinal - minFinal) / (maxFinal - minFinal) : 0.f;
+	}
+
+	void oldNormalizeMax(std::vector<float> &layer)
+	{
+		float maxValue{};
+
+		for (float value : layer)
+			maxValue = std::max(maxValue, value);
+
+		if (maxValue > 0)
+			for (float &value : layer)
+				value /= maxValue;
+	}
+
+	void oldNormalizeFinite(std::vector<float> const &src, std::vector<float> &dst)
+	{
+		float maxValue{};
+
+		for (float value : src)
+			if (value < std::numeric_limits<float>::max())
+				maxValue = std::max(maxValue, value);
+
+		for (size_t index{}; index < src.size(); ++index)
+			dst[index] = maxValue > 0 ? src[index] / maxValue : src[index];
+	}
+
+	// the vision update as it was before the ray fan: atan2 and a full isClearPath per cell in range
+	bool oldLineIntersect(Vec2 const &line0P0, Vec2 const &line0P1, Vec2 const &line1P0, Vec2 const &line1P1)
+	{
+		const float y4y3 = line1P1.y - line1P0.y;
+		const float y1y3 = line0P0.y - line1P0.y;
+		const float y2y1 = line0P1.y - line0P0.y;
+		const float x4x3 = line1P1.x - line1P0.x;
+		const float x2x1 = line0P1.x - line0P0.x;
+		const float x1x3 = line0P0.x - line1P0.x;
+
+		const float divisor = y4y3 * x2x1 - x4x3 * y2y1;
+		const float dividend0 = x4x3 * y1y3 - y4y3 * x1x3;
+		const float dividend1 = x2x1 * y1y3 - y2y1 * x1x3;
+
+		const float eps = 0.0001f;
+		if (std::abs(dividend0) < eps && std::abs(dividend1) < eps && std::abs(divisor) < eps)
+			return true;
+
+		if (std::abs(divisor) < eps)
+			return false;
+
+		const float quotient0 = dividend0 / divisor;
+		const float quotient1 = dividend1 / divisor;
+
+		return !(quotient0 < 0.0f || quotient0 > 1.0f || quotient1 < 0.0f || quotient1 > 1.0f);
+	}
+
+	bool oldIsClearPath(BenchMap const &map, float cellSize, int row0, int col0, int row1, int col1)
+	{
+		Vec2 p0{ col0 * cellSize, row0 * cellSize };
+		Vec2 p1{ col1 * cellSize, row1 * cellSize };
+		float halfGridWidth = 0.5f * cellSize;
+		halfGridWidth += halfGridWidth * EPSILON;
+
+		int sx = row0 < row1 ? 1 : -1;
+		int sy = col0 < col1 ? 1 : -1;
+
+		for (int row = row0; (sx > 0) ? (row <= row1) : (row >= row1); row += sx)
+			for (int col = col0; (sy > 0) ? (col <= col1) : (col >= col1); col += sy)
+			{
+				bool isWall = row < 0 || col < 0 || row >= map.height || col >= map.width || map.walls[row * map.width + col];
+
+				if (!isWall || (row == row0 && col == col0) || (row == row1 && col == col1))
+					continue;
+
+				Vec2 wallCenter{ col * cellSize, row * cellSize };
+				Vec2 l1p0 = { wallCenter.x - halfGridWidth, wallCenter.y + halfGridWidth };
+				Vec2 l1p1 = { wallCenter.x + halfGridWidth, wallCenter.y - halfGridWidth };
+				Vec2 l2p0 = { wallCenter.x + halfGridWidth, wallCenter.y + halfGridWidth };
+				Vec2 l2p1 = { wallCenter.x - halfGridWidth, wallCenter.y - halfGridWidth };
+
+				if (oldLineIntersect(p0, p1, l1p0, l1p1) || oldLineIntersect(p0, p1, l2p0, l2p1))
+					return false;
+			}
+
+		return true;
+	}
+
+	// one entity's cone and circle, seen cells are set to 1
+	void oldFieldOfView(BenchMap const &map, float cellSize, Vec2 p, Vec2 direction, FovConfig const &fov, std::vector<float> &seen)
+	{
+		int row0 = static_cast<int>((p.y + 0.5f * cellSize) / cellSize);
+		int col0 = static_cast<int>((p.x + 0.5f * cellSize) / cellSize);
+		float directionAngle = atan2(direction.y, direction.x);
+		float halfAngle = fov.coneAngle * (PI / 180.0f) / 2.0f;
+
+		auto sweep = [&](float radius, bool isCone)
+			{
+				int reach = static_cast<int>(radius / cellSize);
+
+				for (int r = std::max(0, row0 - reach); r <= std::min(map.height - 1, row0 + reach); ++r)
+					for (int c = std::max(0, col0 - reach); c <= std::min(map.width - 1, col0 + reach); ++c)
+					{
+						Vec2 directionToCell = Vec2{ c * cellSize, r * cellSize } - p;
+
+						if (directionToCell.Distance(Vec2(0, 0)) > radius)
+							continue;
+
+						if (isCone)
+						{
+							float relativeAngle = atan2(directionToCell.y, directionToCell.x) - directionAngle;
+
+							if (relativeAngle > PI) relativeAngle -= 2 * PI;
+							if (relativeAngle < -PI) relativeAngle += 2 * PI;
+
+							if (fabs(relativeAngle) > halfAngle)
+								continue;
+						}
+
+						if (oldIsClearPath(map, cellSize, row0, col0, r, c))
+							seen[r * map.width + c] = 1.f;
+					}
+			};
+
+		sweep(fov.coneRadius, true);
+		sweep(fov.circleRadius, false);
+	}
+
+	float maxDifference(std::vector<float> const &lhs, std::vector<float> const &rhs)
+	{
+		float maxError{};
+
+		for (size_t index{}; index < lhs.size(); ++index)
+			if (lhs[index] != UNREACHED && rhs[index] != UNREACHED)
+				maxError = std::max(maxError, std::abs(lhs[index] - rhs[index]));
+
+		return maxError;
+	}
+
+	template <typename Func>
+	double timeMs(int repeats, Func func)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i{}; i < repeats; ++i)
+			func();
+
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+namespace bench
+{
+	// @brief times the old FIFO heat map relaxation against the serial and tiled bucket queue solvers
+	// @param size: rows and columns of the generated square map
+	// @param repeats: number of solves per implementation
+	std::vector<Result> heatMap(int size, int repeats)
+	{
+		BenchMap map(size, 0.2f, 0.01f);
+		std::vector<float> fifo(size * size), exact(size * size), tiled(size * size);
+		std::vector<unsigned char> canEnter(size * size), blocksCorner(size * size);
+		BucketQueue queue;
+		TiledFieldSolver solver;
+		std::vector<Result> results;
+		std::string threads = " (" + std::to_string(jobs.getThreadCount()) + " threads)";
+		long long items = (long long)size * size * repeats;
+
+		for (bool isExitMap : { false, true })
+		{
+			std::string mapName = isExitMap ? "exit map" : "exploration map";
+
+			double fifoMs = timeMs(repeats, [&] { fifoHeatMap(map, fifo, isExitMap); });
+			double bucketMs = timeMs(repeats, [&] { bucketHeatMap(map, exact, queue, canEnter, blocksCorner, isExitMap); });
+			double tiledMs = timeMs(repeats, [&] { tiledHeatMap(map, tiled, solver, canEnter, blocksCorner, isExitMap); });
+
+			results.push_back({ "FIFO " + mapName + " (old)", items, fifoMs, maxDifference(fifo, exact) });
+			results.push_back({ "Bucket queue " + mapName, items, bucketMs, 0.f });
+			results.push_back({ "Tiled bucket queue " + mapName + threads, items, tiledMs, maxDifference(tiled, exact) });
+		}
+
+		return results;
+	}
+
+	// @brief times the old per-layer combine/ normalize loops against the fused kernels
+	// @param size: rows and columns of the generated square layers
+	// @param repeats: number of runs per implementation
+	std::vector<Result> fieldKernels(int size, int repeats)
+	{
+		size_t count = (size_t)size * size;
+		std::vector<float> distance(count), repulsion(count), potential(count), heat(count);
+		std::vector<float> oldLayer(count), newLayer(count);
+		std::vector<unsigned char> walls(count);
+		std::vector<Result> results;
+		std::mt19937 rng(380);
+		std::uniform_real_distribution<float> roll(0.f, 1.f);
+		std::string isa = " (" + std::string(kernel::getIsa()) + ")";
+		long long items = (long long)count * repeats;
+
+		for (size_t index{}; index < count; ++index)
+		{
+			walls[index] = roll(rng) < 0.2f;
+			distance[index] = roll(rng);
+			repulsion[index] = roll(rng) * 0.3f;
+			potential[index] = roll(rng);
+			heat[index] = roll(rng) < 0.01f ? UNREACHED : roll(rng) * size;
+		}
+
+		// bytes per cell: combine reads 3 layers + walls + final and writes final, then rescales final
+		// normalizing reads the layer for the max, then reads and writes it again
+		long long combineBytes = items * (3 * 4 + 1 + 4 + 4 + 8);
+		long long normalizeBytes = items * (4 + 8);
+
+		double oldMs = timeMs(repeats, [&] { oldCombine(distance, repulsion, potential, walls, 0.5f, oldLayer); });
+		double newMs = timeMs(repeats, [&] { kernel::combine(distance.data(), repulsion.data(), potential.data(), walls.data(), 0.5f, newLayer.data(), count); });
+		results.push_back({ "Combine maps (old)", items, oldMs, 0.f, combineBytes });
+		results.push_back({ "Combine maps" + isa, items, newMs, maxDifference(oldLayer, newLayer), combineBytes });
+
+		// the layers are refilled every run so the division isn't a no-op after the first (counted as a copy)
+		oldMs = timeMs(repeats, [&] { oldLayer = repulsion; oldNormalizeMax(oldLayer); });
+		newMs = timeMs(repeats, [&] { newLayer = repulsion; kernel::normalizeMax(newLayer.data(), count); });
+		results.push_back({ "Normalize max (old)", items, oldMs, 0.f, normalizeBytes + items * 8 });
+		results.push_back({ "Normalize max" + isa, items, newMs, maxDifference(oldLayer, newLayer), normalizeBytes + items * 8 });
+
+		oldMs = timeMs(repeats, [&] { oldNormalizeFinite(heat, oldLayer); });
+		newMs = timeMs(repeats, [&] { kernel::normalizeFinite(heat.data(), newLayer.data(), count); });
+		results.push_back({ "Normalize heat map (old)", items, oldMs, 0.f, normalizeBytes });
+		results.push_back({ "Normalize heat map" + isa, items, newMs, maxDifference(oldLayer, newLayer), normalizeBytes });
+
+		return results;
+	}
+
+	// @brief times the old per-cell vision update against the ray fan sweep
+	// @param size: rows and columns of the generated square map
+	// @param entities: number of entities looking around
+	// @param repeats: number of updates per implementation
+	std::vector<Result> fieldOfView(int size, int entities, int repeats)
+	{
+		BenchMap map(size, 0.2f, 0.f);
+		float cellSize = 100.f;
+		std::vector<std::pair<Vec2, Vec2>> viewers;
+		std::vector<float> oldSeen(size * size), newSeen(size * size);
+		std::vector<Result> results;
+		std::mt19937 rng(380);
+		std::uniform_real_distribution<float> roll(0.f, 1.f);
+		RayFan fan;
+		long long items = (long long)entities * repeats;
+
+		for (int i{}; i < entities; ++i)
+		{
+			Vec2 pos{ roll(rng) * (size - 1) * cellSize, roll(rng) * (size - 1) * cellSize };
+			float angle = roll(rng) * 2.f * PI;
+			viewers.push_back({ pos, Vec2{ std::cos(angle), std::sin(angle) } });
+		}
+
+		FovConfig longRange{ 4.f * FovConfig{}.coneRadius, FovConfig{}.coneAngle, 4.f * FovConfig{}.circleRadius };
+
+		for (FovConfig const &fov : { FovConfig{}, longRange })
+		{
+			std::string range = " (" + std::to_string(static_cast<int>(fov.coneRadius / cellSize)) + " cell cone)";
+			float halfAngle = fov.coneAngle * (PI / 180.0f) / 2.0f;
+
+			double oldMs = timeMs(repeats, [&]
+				{
+					std::fill(oldSeen.begin(), oldSeen.end(), 0.f);
+					for (auto const &[pos, direction] : viewers)
+						oldFieldOfView(map, cellSize, pos, direction, fov, oldSeen);
+				});
+
+			// the fan is built inside the timing, once per configuration like the vision update does
+			fan = RayFan{};
+			double newMs = timeMs(repeats, [&]
+				{
+					fan.build(getVisionReach(cellSize, fov.coneRadius, fov.circleRadius));
+					std::fill(newSeen.begin(), newSeen.end(), 0.f);
+					for (auto const &[pos, direction] : viewers)
+						castVision(fan, size, size, map.walls.data(), cellSize, pos, direction, fov.coneRadius, halfAngle, fov.circleRadius,
+							[&](int row, int col) { newSeen[row * size + col] = 1.f; });
+				});
+
+			results.push_back({ "Per-cell vision" + range + " (old)", items, oldMs, 0.f });
+			results.push_back({ "Ray fan vision" + range, items, newMs, maxDifference(oldSeen, newSeen) });
+		}
+
+		return results;
+	}
+
+	// @brief times a loop of single line of sight traces against the batched kernel, from a few origins to every cell around them
+	// @param size: rows and columns of the generated square map
+	// @param repeats: number of batches per implementation
+	std::vector<Result> lineOfSight(int size, int repeats)
+	{
+		BenchMap map(size, 0.1f, 0.f);
+		int reach = std::min(32, size / 2);
+		std::vector<int> targets;
+		std::vector<std::pair<int, int>> origins;
+		std::vector<std::uint32_t> loopClear, batchClear;
+		std::vector<Result> results;
+		std::mt19937 rng(380);
+		std::uniform_int_distribution<int> roll(reach, size - reach - 1);
+		std::string isa = " (" + std::string(kernel::getIsa()) + ")";
+
+		for (int i{}; i < 16; ++i)
+			origins.push_back({ roll(rng), roll(rng) });
+
+		long long items = (long long)origins.size() * (2 * reach + 1) * (2 * reach + 1) * repeats;
+
+		auto run = [&](std::vector<std::uint32_t> &clear, bool isBatched)
+			{
+				clear.clear();
+
+				for (auto const &[row, col] : origins)
+				{
+					targets.clear();
+
+					for (int r{ row - reach }; r <= row + reach; ++r)
+						for (int c{ col - reach }; c <= col + reach; ++c)
+						{
+							targets.push_back(r);
+							targets.push_back(c);
+						}
+
+					size_t count = targets.size() / 2, first = clear.size();
+					clear.resize(first + (count + 31) / 32, 0u);
+
+					if (isBatched)
+					{
+						kernel::traceLines(size, size, map.walls.data(), row, col, targets.data(), count, clear.data() + first);
+						continue;
+					}
+
+					for (size_t i{}; i < count; ++i)
+					{
+						int dr = targets[2 * i] - row, dc = targets[2 * i + 1] - col;
+						bool isClear = (!dr && !dc) || traceLine(dr, dc, [&](int r, int c) { return map.walls[(row + r) * size + col + c] != 0; });
+
+						if (isClear)
+							clear[first + i / 32] |= 1u << (i % 32);
+					}
+				}
+			};
+
+		double loopMs = timeMs(repeats, [&] { run(loopClear, false); });
+		double batchMs = timeMs(repeats, [&] { run(batchClear, true); });
+
+		results.push_back({ "Line of sight loop", items, loopMs, 0.f });
+		results.push_back({ "Batched line of sight" + isa, items, batchMs, loopClear == batchClear ? 0.f : 1.f });
+
+		return results;
+	}
+
+	// @brief times A*, JPS and JPS+ path queries against solving a full flow field to the same goal
+	// @param size: rows and columns of the generated square map
+	// @param repeats: number of runs over the queries per implementation
+	std::vector<Result> pathFinding(int size, int repeats)
+	{
+		BenchMap map(size, 0.1f, 0.f);
+		std::vector<std::pair<int, int>> queries;
+		std::vector<float> dist(size * size), pathCost;
+		std::vector<unsigned char> canEnter(size * size), blocksCorner(size * size);
+		std::vector<int> path;
+		BucketQueue queue;
+		PathFinder finder;
+		std::vector<Result> results;
+		std::mt19937 rng(380);
+		std::uniform_int_distribution<int> roll(0, size * size - 1);
+
+		while (queries.size() < 16)
+		{
+			int start = roll(rng), goal = roll(rng);
+			if (!map.walls[start] && !map.walls[goal])
+				queries.push_back({ start, goal });
+		}
+
+		long long items = (long long)queries.size() * repeats;
+
+		// the field is the reference, every path should cost what it says the start is from the goal
+		std::vector<float> fieldDist(queries.size());
+		double fieldMs = timeMs(repeats, [&]
+			{
+				for (size_t i{}; i < queries.size(); ++i)
+				{
+					for (int index{}; index < size * size; ++index)
+					{
+						canEnter[index] = !map.walls[index];
+						blocksCorner[index] = map.walls[index];
+						dist[index] = UNREACHED;
+					}
+
+					dist[queries[i].second] = 0.f;
+					queue.push(0.f, queries[i].second);
+					solveField(size, size, canEnter, blocksCorner, dist, nullptr, queue);
+					fieldDist[i] = dist[queries[i].first];
+				}
+			});
+		results.push_back({ "Flow field per query", items, fieldMs, 0.f });
+
+		double buildMs = timeMs(1, [&] { finder.buildJumpTable(size, size, map.walls); });
+		results.push_back({ "JPS+ jump table build (once per map)", (long long)size * size, buildMs, 0.f });
+
+		char const *names[] = { "A*", "JPS", "JPS+" };
+
+		for (PathMethod method : { PathMethod::ASTAR, PathMethod::JPS, PathMethod::JPS_PLUS })
+		{
+			pathCost.assign(queries.size(), UNREACHED);
+
+			double ms = timeMs(repeats, [&]
+				{
+					for (size_t i{}; i < queries.size(); ++i)
+						if (finder.findPath(size, size, map.walls, queries[i].first, queries[i].second, method, path))
+						{
+							float cost{};
+
+							for (size_t k{ 1 }; k < path.size(); ++k)
+							{
+								int rows = std::abs(path[k] / size - path[k - 1] / size), cols = std::abs(path[k] % size - path[k - 1] % size);
+								cost += std::min(rows, cols) * DIAG_COST + std::abs(rows - cols) * ORTH_COST;
+							}
+
+							pathCost[i] = cost;
+						}
+				});
+
+			results.push_back({ std::string(names[static_cast<int>(method)]) + " path", items, ms, maxDifference(pathCost, fieldDist) });
+		}
+
+		return results;
+	}
+
+	// @brief times the enemy separation with every pair tried against the spatial hash broad phase, for 100, 1k and 10k agents
+	// @param repeats: number of separation passes per implementation and agent count
+	std::vector<Result> separation(int repeats)
+	{
+		std::vector<Result> results;
+		std::mt19937 rng(380);
+		float cellSize = 100.f;
+		Vec2 scale{ 30.f, 40.f };	// default enemy size
+
+		for (int agents : { 100, 1000, 10000 })
+		{
+			// crowded enough that most agents touch a neighbour or two
+			int size = std::max(4, static_cast<int>(std::sqrt(static_cast<float>(agents)) * 45.f / cellSize));
+			BenchMap map(size, 0.05f, 0.f);
+			std::uniform_real_distribution<float> roll(0.f, size * cellSize);
+			std::vector<Vec2> start, scales(agents, scale), pairLoop, hashed;
+
+			auto isBlocked = [&](Vec2 pos)
+				{
+					int row = static_cast<int>(std::floor(pos.y / cellSize)), col = static_cast<int>(std::floor(pos.x / cellSize));
+					return row < 0 || row >= size || col < 0 || col >= size || map.walls[row * size + col];
+				};
+
+			while (static_cast<int>(start.size()) < agents)
+			{
+				Vec2 pos{ roll(rng), roll(rng) };
+				if (!isBlocked(pos))
+					start.push_back(pos);
+			}
+
+			// every pass starts from the same crowd, the copy is timed for both
+			AgentSeparation separation;
+			Vec2 mapSize{ size * cellSize, size * cellSize };
+			std::string count = " (" + std::to_string(agents) + " agents)";
+			long long items = (long long)agents * repeats;
+
+			separation.useSpatialHash = false;
+			double loopMs = timeMs(repeats, [&] { pairLoop = start; separation.resolve(pairLoop, scales, mapSize, nullptr, isBlocked); });
+
+			separation.useSpatialHash = true;
+			double hashMs = timeMs(repeats, [&] { hashed = start; separation.resolve(hashed, scales, mapSize, nullptr, isBlocked); });
+
+			// the hash should hand over every pair the loop resolves, so the crowds should end up the same
+			float maxError{};
+			for (int i{}; i < agents; ++i)
+				maxError = std::max(maxError, (pairLoop[i] - hashed[i]).Length());
+
+			results.push_back({ "Separation pair loop" + count, items, loopMs, 0.f });
+			results.push_back({ "Separation spatial hash" + count, items, hashMs, maxError });
+		}
+
+		return results;
+	}
+
+	std::vector<Result> typeLookup(int repeats)
+	{
+		constexpr int CALLS = 100000;
+
+		// the old lookup, the stores keyed by their trimmed typeid names
+		std::unordered_map<std::string, AgentStore const *> byName;
+		for (const Factory::EntityType &type : factory.getAllEntities())
+			byName[type.name] = &type.agents;
+
+		Arrow *arrow = factory.createEntity<Arrow>();
+		AgentHandle handle = arrow->getHandle();
+		long long items = (long long)CALLS * repeats;
+		int byNameAlive{}, byIndexAlive{};
+
+		double nameMs = timeMs(repeats, [&]
+			{
+				for (int i{}; i < CALLS; ++i)
+				{
+					std::string type = typeid(Arrow).name();
+					type = utl::trimString(type, "class ");
+					crashIf(!byName.count(type), "Entity of type " + utl::quote(type) + " does not exist");
+					byNameAlive += byName.at(type)->isAlive(handle);
+				}
+			});
+
+		double indexMs = timeMs(repeats, [&]
+			{
+				for (int i{}; i < CALLS; ++i)
+					byIndexAlive += factory.isEntityAlive<Arrow>(handle);
+			});
+
+		factory.destroyEntity<Arrow>(handle);
+
+		// every call should have found the arrow
+		std::vector<Result> results;
+		results.push_back({ "Type lookup typeid string", items, nameMs, static_cast<float>(items - byNameAlive) });
+		results.push_back({ "Type lookup type index", items, indexMs, static_cast<float>(items - byIndexAlive) });
+		return results;
+	}
+}
@@ -0,0 +1,71 @@
+//==============================================================================
+/*!
+\file		Benchmark.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the benchmark functionalities
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+namespace bench
+{
+	// one timed run of a benchmark
+	struct Result
+	{
+		std::string name;		// what was measured
+		long long items{};		// cells/ rays/ agents processed over all repeats
+		double ms{};			// total wall time
+		float maxError{};		// largest difference to the reference result (0 for the reference itself)
+		long long bytes{};		// memory touched over all repeats (0 if not a bandwidth benchmark)
+
+		double itemsPerSecond() const { return ms > 0.0 ? items / (ms / 1000.0) : 0.0; }
+		double gbPerSecond() const { return ms > 0.0 ? bytes / (ms / 1000.0) / 1e9 : 0.0; }
+	};
+
+	// @brief times the old FIFO heat map relaxation against the serial and tiled bucket queue solvers
+	// @param size: rows and columns of the generated square map
+	// @param repeats: number of solves per implementation
+	std::vector<Result> heatMap(int size, int repeats);
+
+	// @brief times the old per-layer combine/ normalize loops against the fused kernels
+	// @param size: rows and columns of the generated square layers
+	// @param repeats: number of runs per implementation
+	std::vector<Result> fieldKernels(int size, int repeats);
+
+	// @brief times the old per-cell vision update against the ray fan sweep
+	// @param size: rows and columns of the generated square map
+	// @param entities: number of entities looking around
+	// @param repeats: number of updates per implementation
+	std::vector<Result> fieldOfView(int size, int entities, int repeats);
+
+	// @brief times a loop of single line of sight traces against the batched kernel, from a few origins to every cell around them
+	// @param size: rows and columns of the generated square map
+	// @param repeats: number of batches per implementation
+	std::vector<Result> lineOfSight(int size, int repeats);
+
+	// @brief times A*, JPS and JPS+ path queries against solving a full flow field to the same goal
+	// @param size: rows and columns of the generated square map
+	// @param repeats: number of runs over the queries per implementation
+	std::vector<Result> pathFinding(int size, int repeats);
+
+	// @brief times the enemy separation with every pair tried against the spatial hash broad phase, for 100, 1k and 10k agents
+	// @param repeats: number of separation passes per implementation and agent count
+	std::vector<Result> separation(int repeats);
+
+	// @brief times the per call cost of finding an entity type's store by its typeid string, the way the factory used to,
+	//        against the type index of the live factory. both ask whether a waypoint arrow is still alive
+	// @param repeats: number of batches of 100k calls per implementation
+	std::vector<Result> typeLookup(int repeats);
+}
+
+#endif // !BENCHMARK_H
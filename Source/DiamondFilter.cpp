@@ -0,0 +1,128 @@
+//==============================================================================
+/*!
+\file		DiamondFilter.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the DiamondFilter class
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "DiamondFilter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// prefix sum at (row, col), 0 outside the padded domain
+	inline int sumAt(std::vector<int> const &layer, int index, bool isInside) { return isInside ? layer[index] : 0; }
+}
+
+int DiamondFilter::columnSum(int col, int row0, int row1) const
+{
+	bool hasTop = row0 - 1 >= rowMin;
+	return column[at(row1, col)] - sumAt(column, hasTop ? at(row0 - 1, col) : 0, hasTop);
+}
+
+int DiamondFilter::diagonalSum(int row, int col, int len) const
+{
+	if (len <= 0)
+		return 0;
+
+	bool hasTop = row - 1 >= rowMin && col - 1 >= colMin;
+	return diagonal[at(row + len - 1, col + len - 1)] - sumAt(diagonal, hasTop ? at(row - 1, col - 1) : 0, hasTop);
+}
+
+int DiamondFilter::antiDiagonalSum(int row, int col, int len) const
+{
+	if (len <= 0)
+		return 0;
+
+	bool hasTop = row - 1 >= rowMin && col + 1 < colMin + cols;
+	return antiDiagonal[at(row + len - 1, col - len + 1)] - sumAt(antiDiagonal, hasTop ? at(row - 1, col + 1) : 0, hasTop);
+}
+
+void DiamondFilter::apply(int height, int width, std::vector<std::pair<int, int>> const &centres, float radius, float scale, std::vector<float> &out)
+{
+	out.assign(height * width, 0.f);
+
+	if (!(radius > 0.f) || centres.empty())
+		return;
+
+	// cells closer than radius get radius - md = frac + (r - md) for md <= r
+	int r = static_cast<int>(std::ceil(radius)) - 1;
+	float frac = radius - r;
+
+	// every triangle and boundary looked up while sweeping the grid rows stays inside this
+	rowMin = -r - 2;
+	colMin = -3 * r - 3;
+	rows = height + 2 * r + 4;
+	cols = width + 5 * r + 7;
+
+	column.assign(rows * cols, 0);
+	diagonal.assign(rows * cols, 0);
+	antiDiagonal.assign(rows * cols, 0);
+
+	// centres more than r rows or columns outside can't reach the grid
+	for (auto const &[row, col] : centres)
+		if (row >= -r && col >= -r && row < height + r && col < width + r)
+			++column[at(row, col)];
+
+	for (int row{ rowMin }; row < rowMin + rows; ++row)
+		for (int col{ colMin }; col < colMin + cols; ++col)
+		{
+			int index = at(row, col);
+			int count = column[index];
+
+			if (row == rowMin)
+			{
+				diagonal[index] = antiDiagonal[index] = count;
+				continue;
+			}
+
+			column[index] += column[at(row - 1, col)];
+			diagonal[index] = count + (col > colMin ? diagonal[at(row - 1, col - 1)] : 0);
+			antiDiagonal[index] = count + (col + 1 < colMin + cols ? antiDiagonal[at(row - 1, col + 1)] : 0);
+		}
+
+	// right triangle: cells right of the apex column with |dr| + dc <= size, left triangle mirrored.
+	// moving the apex one column right drops/ adds a column and a diagonal boundary on each side
+	auto stepRight = [this](int &triangle, int row, int col, int size)
+		{
+			triangle += diagonalSum(row - size, col + 1, size + 1) + antiDiagonalSum(row + 1, col + size, size) - columnSum(col, row - size, row + size);
+		};
+	auto stepLeft = [this](int &triangle, int row, int col, int size)
+		{
+			triangle += columnSum(col + 1, row - size, row + size) - antiDiagonalSum(row - size, col, size + 1) - diagonalSum(row + 1, col - size + 1, size);
+		};
+
+	for (int row{}; row < height; ++row)
+	{
+		// start left of every centre, where all counts are 0
+		int rightFull{}, leftFull{}, rightInner{}, leftInner{}, cone{};
+
+		for (int col{ -2 * r - 1 }; col < width; ++col)
+		{
+			if (col >= 0)
+			{
+				int diamond = leftFull + rightFull - columnSum(col, row - r, row + r);
+				out[row * width + col] = scale * (frac * diamond + cone);
+			}
+
+			// cone(p + 1) = cone(p) + right triangle(p + 1) - left triangle(p), both one smaller
+			stepRight(rightFull, row, col, r);
+			stepLeft(leftFull, row, col, r);
+
+			if (r > 0)
+			{
+				cone -= leftInner;
+				stepRight(rightInner, row, col, r - 1);
+				stepLeft(leftInner, row, col, r - 1);
+				cone += rightInner;
+			}
+		}
+	}
+}
@@ -0,0 +1,51 @@
+//==============================================================================
+/*!
+\file		DiamondFilter.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the DiamondFilter class
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef DIAMONDFILTER_H
+#define DIAMONDFILTER_H
+
+#include <vector>
+#include <utility>
+
+// convolves a set of centres with a manhattan cone (linear falloff over a diamond):
+// out[cell] = scale * sum over centres of max(radius - md(cell, centre), 0)
+// the cone is built from running triangle counts along each row, which are kept up to
+// date with column/ diagonal prefix sums, so the cost is O(cells + radius * rows) no
+// matter how many centres there are
+class DiamondFilter
+{
+	// prefix sums of the centre image over a padded domain
+	std::vector<int> column;		// down the column
+	std::vector<int> diagonal;		// down-right
+	std::vector<int> antiDiagonal;	// down-left
+	int rowMin{}, colMin{};			// padded domain origin
+	int rows{}, cols{};				// padded domain size
+
+	int at(int row, int col) const { return (row - rowMin) * cols + col - colMin; }
+
+	//! centres in rows [row0, row1] of a column
+	int columnSum(int col, int row0, int row1) const;
+	//! centres on len cells going down-right from (row, col)
+	int diagonalSum(int row, int col, int len) const;
+	//! centres on len cells going down-left from (row, col)
+	int antiDiagonalSum(int row, int col, int len) const;
+
+public:
+
+	// @brief fills out (height * width, row-major) with the filtered centres
+	// @param centres: (row, col) of every centre, may lie outside the grid
+	// @param radius: cells at this manhattan distance or further get nothing
+	void apply(int height, int width, std::vector<std::pair<int, int>> const &centres, float radius, float scale, std::vector<float> &out);
+};
+
+#endif // !DIAMONDFILTER_H
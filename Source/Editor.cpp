@@ -26,6 +26,7 @@ extern sf::RenderWindow window;
 extern float dt;
 extern bool isPaused;
 extern DrawMode mode;
+extern int enemyGroup;
 extern MapConfig config;
 extern FovConfig fov;
 extern PotentialConfig pConfig;
@@ -123,47 +124,47 @@ void Inspector::onUpdate()
 	ImGui::Begin(name.c_str(), &isOpen);
 	int count = 0;
 	
-	for (const auto &[type, entities] : factory.getAllEntities())
+	for (const Factory::EntityType &type : factory.getAllEntities())
 	{
-		ImGui::SeparatorText((type + " entities").c_str());
+		ImGui::SeparatorText((type.name + " entities").c_str());
 
-		for (const auto &[entityPtr, entity] : entities)
+		for (Entity *entity : type.agents.owner)
 		{
 			if (ImGui::CollapsingHeader(("Entity " + std::to_string(++count)).c_str()))
 			{
 				// pos
 				Vec2 mapSize = { grid.getWidth() * grid.getCellSize(), grid.getHeight() * grid.getCellSize() };
 				ImGui::SliderFloat(("[" + std::to_string(count) + "] X Position").c_str(), 
-					&entity->pos.x, 0.f, mapSize.x);
+					&entity->pos().x, 0.f, mapSize.x);
 				ImGui::SliderFloat(("[" + std::to_string(count) + "] Y Position").c_str(),
-					&entity->pos.y, 0.f, mapSize.y);
+					&entity->pos().y, 0.f, mapSize.y);
 
 				// dir
 				ImGui::SliderFloat(("[" + std::to_string(count) + "] X Direction").c_str(), 
-					&entity->dir.x, -1.f, 1.f);
+					&entity->dir().x, -1.f, 1.f);
 				ImGui::SliderFloat(("[" + std::to_string(count) + "] Y Direction").c_str(),
-					&entity->dir.y, -1.f, 1.f);
+					&entity->dir().y, -1.f, 1.f);
 
 				// color
-				float color[4] = { entity->color.r / 256.f, entity->color.g / 256.f, entity->color.b / 256.f,
-				entity->color.a / 256.f };
+				float color[4] = { entity->color().r / 256.f, entity->color().g / 256.f, entity->color().b / 256.f,
+				entity->color().a / 256.f };
 				ImGui::ColorEdit4(("[" + std::to_string(count) + "] Colour").c_str(), color);
-				entity->color.r = (sf::Uint8)(color[0] * 256.f);
-				entity->color.g = (sf::Uint8)(color[1] * 256.f);
-				entity->color.b = (sf::Uint8)(color[2] * 256.f);
-				entity->color.a = (sf::Uint8)(color[3] * 256.f);
+				entity->color().r = (sf::Uint8)(color[0] * 256.f);
+				entity->color().g = (sf::Uint8)(color[1] * 256.f);
+				entity->color().b = (sf::Uint8)(color[2] * 256.f);
+				entity->color().a = (sf::Uint8)(color[3] * 256.f);
 
 				// scale
 				ImGui::SliderFloat(("[" + std::to_string(count) + "] X Scale").c_str(), 
-					&entity->scale.x, 0.f, mapSize.x);
+					&entity->scale().x, 0.f, mapSize.x);
 				ImGui::SliderFloat(("[" + std::to_string(count) + "] Y Scale").c_str(), 
-					&entity->scale.y, 0.f, mapSize.y);
+					&entity->scale().y, 0.f, mapSize.y);
 
 				// speed
-				ImGui::SliderFloat("Speed", &entity->speed, 0.f, 1000.f);
+				ImGui::SliderFloat("Speed", &entity->speed(), 0.f, 1000.f);
 
 				// shape
-				static int shapeIndex = entity->shape;
+				static int shapeIndex = entity->shape();
 				const char *shapes[] = { "None", "Circle", "Triangle", "Rectangle" };
 				const char *preview = shapes[shapeIndex];
 
@@ -183,7 +184,7 @@ void Inspector::onUpdate()
 					ImGui::EndCombo();
 				}
 
-				entity->shape = static_cast<Shape>(shapeIndex);
+				entity->shape() = static_cast<Shape>(shapeIndex);
 			}
 		}
 
@@ -219,7 +220,7 @@ void MapMaker::onUpdate()
 
 	static int mapIndex = INVALID;
 	std::vector<const char *> mapNames;
-	const std::unordered_map<std::string, std::vector<std::vector<bool>>> &maps = loader.getMaps();
+	const std::unordered_map<std::string, MapData> &maps = loader.getMaps();
 	std::transform(maps.begin(), maps.end(), std::back_inserter(mapNames), [](const auto &elem) 
 		{ return elem.first.c_str(); });
 
@@ -386,6 +387,7 @@ void MapMaker::onUpdate()
 
 	case DrawMode::GOAL:
 		ImGui::Text("Left click to start exploration");
+		ImGui::Text("Shift left click to walk a searched path");
 		ImGui::Text("Right click to set goal");
 		break;
 	
@@ -398,6 +400,11 @@ void MapMaker::onUpdate()
 	}
 
 	ImGui::PopStyleColor();
+
+	// enemies spawned and goals set from here on belong to this group (-1 follows the shared field)
+	if (mode == DrawMode::ENTITY || mode == DrawMode::GOAL)
+		ImGui::SliderInt("Group", &enemyGroup, -1, 7);
+
 	editor.addSpace(5);
 	ImGui::SeparatorText("Procedural Generation");
 	editor.addSpace(2);
@@ -523,6 +530,33 @@ void ControlPanel::onUpdate()
 	ImGui::Checkbox("Draw Vision Radius", &grid.debugDrawRadius);
 	ImGui::Checkbox("Draw Heat Map", &grid.showHeatMap);
 	ImGui::Checkbox("Draw Flow Field", &grid.flowFieldArrow);
+	ImGui::Checkbox("Incremental Heat Map", &grid.incrementalHeatMap);
+	ImGui::Checkbox("Parallel Heat Map", &grid.parallelHeatMap);
+	ImGui::Checkbox("Hierarchical Flow Field", &grid.hierarchicalFlowField);
+	ImGui::Checkbox("Spatial Hash Separation", &factory.separation.useSpatialHash);
+	ImGui::Checkbox("Parallel Movement", &factory.useParallelMovement);
+
+	static std::vector<char const *> pathMethodNames{ "A*", "JPS", "JPS+" };
+
+	if (ImGui::BeginCombo("Path Search", pathMethodNames[static_cast<int>(grid.pathMethod)]))
+	{
+		for (int i = 0; i < static_cast<int>(pathMethodNames.size()); ++i)
+		{
+			const bool isSelected = static_cast<int>(grid.pathMethod) == i;
+			if (ImGui::Selectable(pathMethodNames[i], isSelected))
+				grid.pathMethod = static_cast<PathMethod>(i);
+
+			if (isSelected)
+				ImGui::SetItemDefaultFocus();
+		}
+
+		ImGui::EndCombo();
+	}
+
+	FlowFieldCache const &cache = grid.getFlowFieldCache();
+	ImGui::SliderInt("Field Cache (MB)", &grid.flowFieldCacheMb, 0, 512);
+	ImGui::Text("Cached fields: %zu (%.1f MB)", cache.getSize(), cache.getBytes() / 1048576.f);
+	ImGui::Text("Hits: %zu Misses: %zu", cache.getHits(), cache.getMisses());
 
 	editor.addSpace(5);
 	ImGui::SeparatorText("Fog of War");
@@ -532,6 +566,10 @@ void ControlPanel::onUpdate()
 	ImGui::SliderFloat("Cone Angle", &fov.coneAngle, 0.f, 360.f);
 	ImGui::SliderFloat("Circle Radius", &fov.circleRadius, 0.f, 1000.f);
 
+	int cellCount = grid.getHeight() * grid.getWidth();
+	int unexplored = grid.countUnexplored(0, 0, grid.getHeight(), grid.getWidth());
+	ImGui::Text("Unexplored: %d / %d cells (%.1f%%)", unexplored, cellCount, cellCount ? 100.f * unexplored / cellCount : 0.f);
+
 	editor.addSpace(5);
 	ImGui::SeparatorText("Repulsion Field");
 	editor.addSpace(2);
@@ -561,6 +599,86 @@ void ControlPanel::onExit()
 	Window::onExit();
 }
 
+void Benchmarks::onEnter()
+{
+	Window::onEnter();
+}
+
+void Benchmarks::onUpdate()
+{
+	if (!isOpen)
+		return;
+	Window::onUpdate();
+
+	ImGui::Begin(name.c_str(), &isOpen);
+
+	ImGui::SliderInt("Map Size", &mapSize, 100, 4000);
+	ImGui::SliderInt("Repeats", &repeats, 1, 50);
+	editor.addSpace(2);
+
+	ImGui::SeparatorText("Distance Field");
+	editor.addSpace(2);
+
+	if (ImGui::Button("Run Heat Map Benchmark"))
+		results = bench::heatMap(mapSize, repeats);
+
+	editor.addSpace(5);
+	ImGui::SeparatorText("Field Kernels");
+	editor.addSpace(2);
+
+	if (ImGui::Button("Run Field Kernel Benchmark"))
+		results = bench::fieldKernels(mapSize, repeats);
+
+	editor.addSpace(5);
+	ImGui::SeparatorText("Field Of View");
+	editor.addSpace(2);
+
+	ImGui::SliderInt("Entities", &entities, 1, 1000);
+
+	if (ImGui::Button("Run Field Of View Benchmark"))
+		results = bench::fieldOfView(mapSize, entities, repeats);
+
+	if (ImGui::Button("Run Line Of Sight Benchmark"))
+		results = bench::lineOfSight(mapSize, repeats);
+
+	editor.addSpace(5);
+	ImGui::SeparatorText("Path Finding");
+	editor.addSpace(2);
+
+	if (ImGui::Button("Run Path Finding Benchmark"))
+		results = bench::pathFinding(mapSize, repeats);
+
+	editor.addSpace(5);
+	ImGui::SeparatorText("Agents");
+	editor.addSpace(2);
+
+	if (ImGui::Button("Run Separation Benchmark"))
+		results = bench::separation(repeats);
+
+	if (ImGui::Button("Run Type Lookup Benchmark"))
+		results = bench::typeLookup(repeats);
+
+	editor.addSpace(5);
+	ImGui::SeparatorText("Results");
+	editor.addSpace(2);
+
+	for (const bench::Result &result : results)
+	{
+		ImGui::Text("%s", result.name.c_str());
+		if (result.bytes)
+			ImGui::Text("    %.2f ms, %.2f GB/s, max error %.3g", result.ms, result.gbPerSecond(), result.maxError);
+		else
+			ImGui::Text("    %.2f ms, %.2f M/s, max error %.3f", result.ms, result.itemsPerSecond() / 1e6, result.maxError);
+	}
+
+	ImGui::End();
+}
+
+void Benchmarks::onExit()
+{
+	Window::onExit();
+}
+
 void Editor::init()
 {
 	// Initialize ImGui-SFML
@@ -578,13 +696,13 @@ void Editor::init()
 	addWindow<MapMaker>(true, true);
 	addWindow<SaveAsMapPopup>(false, false);
 	addWindow<ControlPanel>(true, true);
+	addWindow<Benchmarks>(false, true);
 
 	std::transform(colors.begin(), colors.end(), std::back_inserter(colorNames), [](const auto &elem)
 		{ return elem.first.c_str(); });
 	std::generate_n(std::back_inserter(rowNums), 100, [n = 0]() mutable { return std::to_string(++n); });
 	std::transform(rowNums.begin(), rowNums.end(), std::back_inserter(rowNames),
 		[](const auto &elem) { return elem.c_str(); });
-	auto entities = factory.getAllEntities();
 }
 
 void Editor::update()
@@ -19,6 +19,7 @@ written consent of DigiPen Institute of Technology is prohibited.
 #include <string>
 #include <iostream>
 #include "Utility.h"
+#include "Benchmark.h"
 
 class Window
 {
@@ -103,6 +104,22 @@ public:
 	void onExit() override;
 };
 
+class Benchmarks : public Window
+{
+	int mapSize = 1000;					// rows and columns of the generated map
+	int repeats = 5;					// runs per implementation
+	int entities = 100;					// viewers/ agents in the benchmarks that have them
+	std::vector<bench::Result> results;
+
+public:
+
+	Benchmarks(const std::string &_name = "", bool _canBeOpened = true) : Window(_name, _canBeOpened) { };
+
+	void onEnter() override;
+	void onUpdate() override;
+	void onExit() override;
+};
+
 class Editor
 {
 	std::unordered_map<std::string, Window *> windows;
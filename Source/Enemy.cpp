@@ -30,12 +30,12 @@ void Enemy::onDestroy()
 
 bool Enemy::isColliding(Enemy* entity)
 {
-	float lhs_radius = std::min(scale.x, scale.y) * 0.5f;
-	float rhs_radius = std::min(entity->scale.x, entity->scale.y) * 0.5f;
+	float lhs_radius = std::min(scale().x, scale().y) * 0.5f;
+	float rhs_radius = std::min(entity->scale().x, entity->scale().y) * 0.5f;
 
 	float target = (lhs_radius + rhs_radius) * (lhs_radius + rhs_radius);
 
-	float actual = (pos - entity->pos).SquareLength();
+	float actual = (pos() - entity->pos()).SquareLength();
 
 	if (actual <= target)
 	{
@@ -14,6 +14,7 @@ written consent of DigiPen Institute of Technology is prohibited.
 #include <SFML/Graphics.hpp>
 #include "Factory.h"
 #include "Camera.h"
+#include "JobSystem.h"
 
 extern sf::RenderWindow window;
 extern Factory factory;
@@ -21,108 +22,50 @@ extern Grid grid;
 extern Camera camera;
 extern float dt;
 extern bool isPaused;
+extern JobSystem jobs;
 FovConfig fov;
 
 #define TRANSITION_DURATION 1.f // Total time to change direction 
+#define MOVE_CHUNK_SIZE 256 // agents moved by one job
 
-void Entity::move()
+void Entity::onTargetReached()
 {
-	if (!currSpeed)
-		return;
-
-	// CONDITION TO TARGET CELL
-	if ((targetPos - pos).SquareLength() < (pos - (pos + dir * currSpeed * dt)).SquareLength())
-	{
-		std::cout << "Target found\n";
-		currSpeed = 0.f;
-
-		if (waypoints.size())
-		{
-			factory.destroyEntity<Arrow>(wpArrows.front());
-			wpArrows.pop_front();
-			setTargetPos(waypoints.front(), false);
-			waypoints.pop_front();
-		}
-
-		return;
-
-	}
-
-	auto [row, col] = grid.getGridPos(pos);
-
-	// get new direction base on cell
-	vec2 newDir = grid.getFlowFieldDir(row, col);
-
-	if (newDir == Vec2{ 0.f, 0.f })
-		newDir = targetPos - pos;
-	
-	newDir = newDir.Normalize();
-
-	// initial
-	if (targetDir == Vec2{ 0.f, 0.f })
-		targetDir = newDir;
-
-
-	if (dir != targetDir) 
+	if (waypoints.size())
 	{
-		if (transitionTime < TRANSITION_DURATION) 
-		{
-			transitionTime += dt;
-			dir = Lerp(dir, targetDir, transitionTime, TRANSITION_DURATION).Normalize();
-		}
-		else
-		{
-			dir = targetDir;
-			transitionTime = 0.f; // Reset for the next transition
-			targetDir = newDir;
-		}
+		factory.destroyEntity<Arrow>(wpArrows.front());
+		wpArrows.pop_front();
+		setTargetPos(waypoints.front(), false);
+		waypoints.pop_front();
 	}
 	else
-	{
-		targetDir = newDir;
-	}
-
-	pos += dir * currSpeed * dt;
-
-	// collision with wall
-	float wallRadius = std::sqrtf(std::powf(grid.getCellSize(), 2.f) * 2.f) / 2.f;
-	//float entityRadius = std::sqrtf(std::powf(scale.x / 2.f, 2.f) + std::powf(scale.y / 2.f, 2.f));
-	float entityRadius = scale.y / 2.f;
-
-	for (Vec2 wallPos : grid.getNeighborWalls(grid.getGridPos(pos)))
-	{
-		float overlap = wallRadius + entityRadius - wallPos.Distance(pos);
-		if (overlap > 0.f)
-			pos += (pos - wallPos).Normalize() * overlap / 2.f;
-	}
+		followsPath() = false;
 }
 
-
-
 void Entity::setTargetPos(Vec2 _targetPos, bool canClearWaypoints)
 {
 	if (canClearWaypoints)
 	{
 		waypoints.clear();
-		for (Arrow* arrow : wpArrows)
+		for (AgentHandle arrow : wpArrows)
 			factory.destroyEntity<Arrow>(arrow);
 		wpArrows.clear();
+		followsPath() = false;
 	}
 
-	auto [row, col] = grid.getGridPos(pos);
+	auto [row, col] = grid.getGridPos(pos());
 
-	if (grid.getFlowFieldDir(row, col) == Vec2{ 0.f, 0.f })
+	if (!followsPath() && grid.getFlowFieldDir(group(), { row, col }) == Vec2{ 0.f, 0.f })
 		return;
 
-	targetPos = _targetPos;
-	currSpeed = speed;
+	targetPos() = _targetPos;
+	currSpeed() = speed();
 	//dir = dir.Normalize();
 }
 
 void Entity::setWaypoints(const std::list<Vec2>& _waypoints)
 {
 	// clear arrows if any
-	for (Arrow* arrow : wpArrows)
+	for (AgentHandle arrow : wpArrows)
 		factory.destroyEntity<Arrow>(arrow);
 	wpArrows.clear();
 
@@ -135,7 +78,7 @@ void Entity::setWaypoints(const std::list<Vec2>& _waypoints)
 	{
 		if (prev != waypoints.end())
 			wpArrows.push_back(factory.createEntity<Arrow>(prev->Midpoint(*iter),
-				Vec2{ (*iter - *prev).Length(), 0.f }, (*iter - *prev).Normalize()));
+				Vec2{ (*iter - *prev).Length(), 0.f }, (*iter - *prev).Normalize())->getHandle());
 		prev = iter;
 	}
 
@@ -143,70 +86,28 @@ void Entity::setWaypoints(const std::list<Vec2>& _waypoints)
 	waypoints.pop_front();
 }
 
-void Entity::onCreate()
-{
-
-}
-
-void Entity::onUpdate()
+void Entity::setPath(const std::list<Vec2> &path)
 {
-	if (!isPaused)
-		move();
+	followsPath() = !path.empty();
+	setWaypoints(path);
 }
 
-void Entity::onRender()
-{
-	float rot = utl::radToDeg(utl::calcRot(dir)) + 90.f;
-
-	// draw entity
-switch (shape)
-{
-case CIRCLE:
+void Entity::onCreate()
 {
-	sf::CircleShape circle;
-	circle.setRadius(scale.x / 2.f);
-	circle.setPosition(pos - Vec2{ scale.x / 2.f, scale.x / 2.f });
-	circle.setFillColor(color);
-	camera.addCircle(circle);
-	break;
-}
 
-case TRIANGLE:
-{
-	sf::ConvexShape triangle;
-	triangle.setPointCount(3);
-	triangle.setPoint(0, sf::Vector2f(pos.x - scale.x / 2.f, pos.y + scale.y / 2.f));
-	triangle.setPoint(1, sf::Vector2f(pos.x + scale.x / 2.f, pos.y + scale.y / 2.f));
-	triangle.setPoint(2, sf::Vector2f(pos.x, pos.y - scale.y / 2.f));
-	triangle.setOrigin(pos);
-	triangle.setRotation(rot);
-	triangle.setPosition(pos);
-	triangle.setFillColor(color);
-	camera.addTriangle(triangle);
-	break;
 }
 
-case RECTANGLE:
+void Entity::onUpdate()
 {
-	sf::RectangleShape rectangle;
-	rectangle.setSize(sf::Vector2f(scale.x, scale.y));
-	rectangle.setOrigin(scale.x / 2.f, scale.y / 2.f);
-	rectangle.setRotation(rot);
-	rectangle.setPosition(pos);
-	rectangle.setFillColor(color);
-	camera.addRectangle(rectangle);
-	break;
-}
 
-default:
-	break;
-}
 }
 
 void Entity::onDestroy()
 {
-	for (Arrow* arrow : wpArrows)
-		factory.destroyEntity<Arrow>(arrow);
+	// the arrows may already be gone when the factory frees everything
+	for (AgentHandle arrow : wpArrows)
+		if (factory.isEntityAlive<Arrow>(arrow))
+			factory.destroyEntity<Arrow>(arrow);
 	wpArrows.clear();
 }
 
@@ -217,154 +118,217 @@ void Factory::init()
 	addEntityType<Enemy>();
 	addEntityType<Ally>();
 	addEntityType<Arrow>();
+
+	// waypoint arrows come and go every time a path is set
+	reserveEntities<Arrow>(256);
 }
 
-void Factory::update()
+void Factory::attach(AgentStore &store, Entity *entity)
 {
-	std::vector<std::pair<Vec2, Vec2>> entityPositionDirection;
-	for (const auto &[type, map] : entities)
-		for (const auto &[k, v] : map)
-			entityPositionDirection.emplace_back(v->pos, v->dir);
+	entity->store = &store;
+	entity->handle = store.create(entity->initial, entity);
+}
 
-	grid.updateVisibility(entityPositionDirection, fov.coneRadius, fov.coneAngle, fov.circleRadius);
+void Factory::moveAgents(AgentStore &agents)
+{
+	int count = static_cast<int>(agents.size());
+	float wallRadius = std::sqrtf(std::powf(grid.getCellSize(), 2.f) * 2.f) / 2.f;
 
-	for (const auto &[type, map] : entities)
-		for (const auto &[k, v] : map)
-			v->onUpdate();
+	// the flow fields fill in the directions they are asked for, so they are read here before the agents are split
+	// up. past this every agent only reads the grid and writes its own row, which keeps the result the same on any
+	// number of threads
+	flowDirs.resize(count);
+	isTargetReached.assign(count, false);
 
-	std::vector<Enemy *> enemies = factory.getEntities<Enemy>();
+	for (int i{}; i < count; ++i)
+	{
+		// a path goes straight from one waypoint to the next
+		bool needsFlow = agents.currSpeed[i] && !agents.followsPath[i];
+		flowDirs[i] = needsFlow ? grid.getFlowFieldDir(agents.group[i], grid.getGridPos(agents.pos[i])) : Vec2{ 0.f, 0.f };
+	}
+
+	if (useParallelMovement)
+		jobs.parallelFor((count + MOVE_CHUNK_SIZE - 1) / MOVE_CHUNK_SIZE, [&](int chunk)
+			{
+				for (int i{ chunk * MOVE_CHUNK_SIZE }; i < std::min(count, (chunk + 1) * MOVE_CHUNK_SIZE); ++i)
+					moveAgent(agents, i, wallRadius);
+			});
+	else
+		for (int i{}; i < count; ++i)
+			moveAgent(agents, i, wallRadius);
 
-	vec2 centroid{};
+	// waypoints create and destroy arrows, so the agents that got there go on one at a time.
+	// it only destroys arrows, so the rows of a store that moves stay where they are
+	for (int i{}; i < count; ++i)
+		if (isTargetReached[i])
+		{
+			std::cout << "Target found\n";
+			agents.owner[i]->onTargetReached();
+		}
+}
+
+void Factory::moveAgent(AgentStore &agents, int i, float wallRadius)
+{
+	float currSpeed = agents.currSpeed[i];
 
-	for (auto const &p : enemies)
+	if (!currSpeed)
+		return;
+
+	Vec2 &pos = agents.pos[i], &dir = agents.dir[i], &targetDir = agents.targetDir[i];
+	float &transitionTime = agents.transitionTime[i];
+
+	// CONDITION TO TARGET CELL
+	if ((agents.targetPos[i] - pos).SquareLength() < (pos - (pos + dir * currSpeed * dt)).SquareLength())
 	{
-		centroid += p->pos;
+		agents.currSpeed[i] = 0.f;
+		isTargetReached[i] = true;
+		return;
 	}
 
-	centroid.x /= enemies.size();
-	centroid.y /= enemies.size();
+	// get new direction base on cell
+	vec2 newDir = flowDirs[i];
+
+	if (newDir == Vec2{ 0.f, 0.f })
+		newDir = agents.targetPos[i] - pos;
+
+	newDir = newDir.Normalize();
+
+	// initial
+	if (targetDir == Vec2{ 0.f, 0.f })
+		targetDir = newDir;
 
-	for (unsigned i = 0; i < enemies.size(); ++i)
+	if (dir != targetDir)
 	{
-		for (unsigned j = i + 1; j < enemies.size(); ++j)
+		if (transitionTime < TRANSITION_DURATION)
 		{
-			auto &m1 = enemies[i];
-			auto &m2 = enemies[j];
+			transitionTime += dt;
+			dir = Lerp(dir, targetDir, transitionTime, TRANSITION_DURATION).Normalize();
+		}
+		else
+		{
+			dir = targetDir;
+			transitionTime = 0.f; // Reset for the next transition
+			targetDir = newDir;
+		}
+	}
+	else
+	{
+		targetDir = newDir;
+	}
 
-			if (grid.isExitFound())
-			{
-				GridPos exit = grid.exitCell->pos;
-				Vec2 exitPos = grid.getWorldPos(exit);
+	pos += dir * currSpeed * dt;
 
-				if ((m1->pos - exitPos).Length() < 10 || (m2->pos - exitPos).Length() < 10)
-				{
-					continue;
-				}
-			}
+	// collision with wall
+	float entityRadius = agents.scale[i].y / 2.f;
 
-			float scale = std::max(std::max(m1->scale.x, m1->scale.y), std::max(m2->scale.x, m2->scale.y));
+	for (Vec2 wallPos : grid.getNeighborWalls(grid.getGridPos(pos)))
+	{
+		float overlap = wallRadius + entityRadius - wallPos.Distance(pos);
+		if (overlap > 0.f)
+			pos += (pos - wallPos).Normalize() * overlap / 2.f;
+	}
+}
 
-			if (m1->isColliding(m2)) // Adjusted distance check with a small buffer
-			{
-				vec2 direction = m2->pos - m1->pos;
-
-				if (direction == Vec2{ 0.f, 0.f })
-				{
-					if (m1->pos.x < (grid.getWidth() * grid.getCellSize()) / 2.f)
-					{
-						direction.x = (grid.getWidth() * grid.getCellSize());
-					}
-					else
-					{
-						direction.x = 0.f;
-					}
-
-					if (m1->pos.y < (grid.getHeight() * grid.getCellSize()) / 2.f)
-					{
-						direction.y = (grid.getHeight() * grid.getCellSize());
-					}
-					else
-					{
-						direction.y = 0.f;
-					}
-
-				}
-
-				direction = direction.Normalize();
-
-				if (direction.Length() != 1)
-				{
-					direction *= (1 / direction.Length());
-				}
-
-				float currentDistance = (m1->pos - m2->pos).Length();
-				float requiredDistance = scale; // Adjusted required distance with a small buffer
-				float correctionFactor = (requiredDistance - currentDistance) / 2.f;
-
-				vec2 displacement = direction * correctionFactor;
-
-				// Move both m1 and m2 away from each other
-				bool bigger = false;
-
-				if ((m1->pos - centroid).SquareLength() < 200)
-				{
-					bigger = true;
-				}
-
-				vec2 newM1Pos = m1->pos - displacement * (bigger ? 0.25f : 0.5f);
-				vec2 newM2Pos = m2->pos + displacement * (bigger ? 0.25f : 0.5f);
-
-				bool m1CollidesWithWall = grid.isWall(grid.getGridPos(newM1Pos));
-				bool m2CollidesWithWall = grid.isWall(grid.getGridPos(newM2Pos));
-
-				// Adjust positions if they collide with a wall
-				if (m1CollidesWithWall || m2CollidesWithWall)
-				{
-
-					// If m1 collides with a wall, move m2 by the full amount
-					if (m1CollidesWithWall)
-					{
-						newM1Pos = m1->pos; // Reset to original position
-						newM2Pos = m2->pos + displacement; // Move m2 by the full amount
-					}
-
-					// If m2 collides with a wall, move m1 by the full amount
-					if (m2CollidesWithWall)
-					{
-						newM2Pos = m2->pos; // Reset to original position
-						newM1Pos = m1->pos - displacement; // Move m1 by the full amount
-					}
-
-					// Optionally, adjust positions to be just outside the wall boundary
-					// This part can be customized based on the game's logic and requirements
-				}
-
-				// Update positions only if no collision with walls	
-				m1->pos = newM1Pos;
-				m2->pos = newM2Pos;
-			}
+void Factory::renderAgents(AgentStore const &agents)
+{
+	for (size_t i{}; i < agents.size(); ++i)
+	{
+		Vec2 pos = agents.pos[i], scale = agents.scale[i];
+		float rot = utl::radToDeg(utl::calcRot(agents.dir[i])) + 90.f;
+
+		// draw entity
+		switch (agents.shape[i])
+		{
+		case CIRCLE:
+		{
+			sf::CircleShape circle;
+			circle.setRadius(scale.x / 2.f);
+			circle.setPosition(pos - Vec2{ scale.x / 2.f, scale.x / 2.f });
+			circle.setFillColor(agents.color[i]);
+			camera.addCircle(circle);
+			break;
+		}
+
+		case TRIANGLE:
+		{
+			sf::ConvexShape triangle;
+			triangle.setPointCount(3);
+			triangle.setPoint(0, sf::Vector2f(pos.x - scale.x / 2.f, pos.y + scale.y / 2.f));
+			triangle.setPoint(1, sf::Vector2f(pos.x + scale.x / 2.f, pos.y + scale.y / 2.f));
+			triangle.setPoint(2, sf::Vector2f(pos.x, pos.y - scale.y / 2.f));
+			triangle.setOrigin(pos);
+			triangle.setRotation(rot);
+			triangle.setPosition(pos);
+			triangle.setFillColor(agents.color[i]);
+			camera.addTriangle(triangle);
+			break;
+		}
+
+		case RECTANGLE:
+		{
+			sf::RectangleShape rectangle;
+			rectangle.setSize(sf::Vector2f(scale.x, scale.y));
+			rectangle.setOrigin(scale.x / 2.f, scale.y / 2.f);
+			rectangle.setRotation(rot);
+			rectangle.setPosition(pos);
+			rectangle.setFillColor(agents.color[i]);
+			camera.addRectangle(rectangle);
+			break;
+		}
+
+		default:
+			break;
 		}
 	}
+}
+
+void Factory::update()
+{
+	std::vector<std::pair<Vec2, Vec2>> entityPositionDirection;
+	for (const EntityType &type : types)
+		for (size_t i{}; i < type.agents.size(); ++i)
+			entityPositionDirection.emplace_back(type.agents.pos[i], type.agents.dir[i]);
+
+	grid.updateVisibility(entityPositionDirection, fov.coneRadius, fov.coneAngle, fov.circleRadius);
+
+	if (!isPaused)
+		for (EntityType &type : types)
+			moveAgents(type.agents);
+
+	for (const EntityType &type : types)
+		for (Entity *entity : type.agents.owner)
+			entity->onUpdate();
+
+	// push overlapping enemies apart, straight on the packed rows of the store
+	AgentStore &enemies = checkType<Enemy>().agents;
+	Vec2 mapSize{ grid.getWidth() * grid.getCellSize(), grid.getHeight() * grid.getCellSize() };
+	Vec2 exitPos = grid.isExitFound() ? grid.getWorldPos(grid.exitCell->pos) : Vec2{};
+
+	separation.resolve(enemies.pos, enemies.scale, mapSize, grid.isExitFound() ? &exitPos : nullptr,
+		[](Vec2 pos) { return grid.isWall(grid.getGridPos(pos)); });
 
 	grid.render(window);
-	for (const auto &[type, map] : entities)
-		for (const auto &[k, v] : map)
-			v->onRender();
+	for (const EntityType &type : types)
+		renderAgents(type.agents);
 }
 
 void Factory::free()
 {
-	for (const auto& [type, map] : entities)
-		for (const auto& [k, v] : map)
+	// taken from the back one at a time, destroying an entity can destroy its arrows too
+	for (EntityType &type : types)
+		while (type.agents.size())
 		{
-			v->onDestroy();
-			delete v;
+			Entity *entity = type.agents.owner.back();
+			entity->onDestroy();
+			type.agents.destroy(entity->handle);
+			entity->~Entity();
+			type.pool.release(entity);
 		}
 }
 
-const std::unordered_map<std::string, std::unordered_map<Entity*, Entity*>>& Factory::getAllEntities()
+const std::deque<Factory::EntityType> &Factory::getAllEntities()
 {
-	return entities;
+	return types;
 }
 
 void Factory::setEntityPen(const std::string &type)
@@ -16,40 +16,46 @@ written consent of DigiPen Institute of Technology is prohibited.
 
 
 #include <unordered_map>
+#include <deque>
 #include <SFML/Graphics.hpp>
 #include <iterator>
 #include "Vector2D.h"
 #include "Utility.h"
 
 #include "Grid.h"
-
-enum Shape
-{
-	NONE,
-	CIRCLE,
-	TRIANGLE,
-	RECTANGLE,
-	MAX_SHAPES
-};
+#include "Separation.h"
+#include "AgentStore.h"
+#include "ObjectPool.h"
+#include <new>
 
 class Arrow;
 
+// the movement and drawing state of an entity is a row in the store of its type, which the factory walks once per
+// frame. the entity keeps what only it uses and reaches its row through a handle
 class Entity
 {
-	void move();
+	friend class Factory;
+
+	AgentStore *store{ nullptr };
+	AgentHandle handle;
+	Agent initial;	// state it starts with, moved into the store when the factory creates it
+
+	//! row of the store, or the initial state before the entity is in one
+	template <typename T, typename U>
+	T &field(std::vector<T> AgentStore::*column, U Agent::*member)
+	{
+		if (!store)
+			return initial.*member;
+		return (store->*column)[store->rowOf(handle)];
+	}
+
+	//! goes on to the next waypoint once the target is reached
+	void onTargetReached();
 
 public:
 
-	Shape shape;
-	Vec2 pos, targetPos = Vec2();
-	Vec2 scale;
-	sf::Color color;
-	Vec2 dir;
-	Vec2 targetDir;
-	float speed, currSpeed = 0.f;
-	float transitionTime{}; // time taken to transition to new direction
 	std::list<Vec2> waypoints;
-	std::list<Arrow *> wpArrows;
+	std::list<AgentHandle> wpArrows;
 
 	Entity(Vec2 _pos = Vec2(), 
 		Vec2 _scale = { 50.f, 50.f },
@@ -58,21 +64,31 @@ public:
 		const sf::Color &_color = sf::Color::Green,
 		float _speed = 500.f)
 
-		: shape(_shape), 
-		pos(_pos), 
-		scale(_scale),
-		color(_color),
-		dir(_dir), 
-		speed(_speed) { }
+		: initial{ _pos, Vec2(), _scale, _dir, Vec2(), _speed, 0.f, 0.f, -1, false, _shape, _color } { }
 
 	virtual ~Entity() { }
 
+	AgentHandle getHandle() const { return handle; }
+
+	Vec2 &pos() { return field(&AgentStore::pos, &Agent::pos); }
+	Vec2 &targetPos() { return field(&AgentStore::targetPos, &Agent::targetPos); }
+	Vec2 &scale() { return field(&AgentStore::scale, &Agent::scale); }
+	Vec2 &dir() { return field(&AgentStore::dir, &Agent::dir); }
+	Vec2 &targetDir() { return field(&AgentStore::targetDir, &Agent::targetDir); }
+	float &speed() { return field(&AgentStore::speed, &Agent::speed); }
+	float &currSpeed() { return field(&AgentStore::currSpeed, &Agent::currSpeed); }
+	int &group() { return field(&AgentStore::group, &Agent::group); }
+	unsigned char &followsPath() { return field(&AgentStore::followsPath, &Agent::followsPath); }
+	Shape &shape() { return field(&AgentStore::shape, &Agent::shape); }
+	sf::Color &color() { return field(&AgentStore::color, &Agent::color); }
+
 	void setTargetPos(Vec2 _targetPos, bool canClearWaypoints = false);
 	void setWaypoints(const std::list<Vec2> &_waypoints);
+	//! follows the waypoints of a path from Grid::findPath
+	void setPath(const std::list<Vec2> &path);
 
 	virtual void onCreate();
 	virtual void onUpdate();
-	virtual void onRender();
 	virtual void onDestroy();
 };
 
@@ -154,79 +170,130 @@ public:
 
 class Factory
 {
-	std::unordered_map<std::string, std::unordered_map<Entity *, Entity *>> entities;
+public:
+
+	// what the factory keeps for every entity type
+	struct EntityType
+	{
+		std::string name;
+		AgentStore agents;
+		ObjectPool pool;	// memory the entities are built in
+	};
+
+private:
+
+	std::deque<EntityType> types;	// at their type index, a deque so the stores stay put as types are added
 	std::string entityPen;
 
+	//! index of a type into types, set when the type is added
 	template <typename T>
-	std::string checkType()
+	static int &typeIndex()
 	{
-		std::string type = typeid(T).name();
-		type = utl::trimString(type, "class ");
-		crashIf(!entities.count(type), "Entity of type " + utl::quote(type) + " does not exist");
-		return type;
+		static int index{ -1 };
+		return index;
 	}
 
+	template <typename T>
+	EntityType &checkType()
+	{
+		int index = typeIndex<T>();
+		crashIf(index < 0, "Entity of type " + utl::quote(typeid(T).name()) + " does not exist");
+		return types[index];
+	}
+
+	//! puts a new entity's state into the store of its type
+	void attach(AgentStore &store, Entity *entity);
+
+	std::vector<Vec2> flowDirs;				// scratch flow field direction of every agent being moved
+	std::vector<unsigned char> isTargetReached;	// scratch, agents that got to their target while moving
+
+	//! steers and moves every agent of a store along the flow fields
+	void moveAgents(AgentStore &agents);
+	//! moves one agent, only touching its own row so agents can move on any thread
+	void moveAgent(AgentStore &agents, int i, float wallRadius);
+	void renderAgents(AgentStore const &agents);
+
 public:
 
 	//! TEMP
 	//Grid* grid;
 
+	// pushes overlapping enemies apart every update
+	AgentSeparation separation;
+
+	// moves the agents in chunks across the job system, off moves them on the calling thread
+	bool useParallelMovement{ true };
+
 	void init();
 	void update();
 	void free();
 
-	const std::unordered_map<std::string, std::unordered_map<Entity *, Entity *>> &getAllEntities();
+	const std::deque<EntityType> &getAllEntities();
 	void setEntityPen(const std::string &type);
 	Enemy *cloneEnemyAt(Vec2 pos);
 
 	template <typename T>
 	std::vector<T *> getEntities()
 	{
-		std::string type = checkType<T>();
+		// only createEntity<T> adds to a store, so every entity in it is a T
+		AgentStore &store = checkType<T>().agents;
 		std::vector<T *> ret;
-		for (const auto &[k, v] : entities.at(type))
-			ret.push_back(dynamic_cast<T *>(v));
+		ret.reserve(store.size());
+		for (Entity *entity : store.owner)
+			ret.push_back(static_cast<T *>(entity));
 		return ret;
 	}
 
+	//! entity of a handle, nullptr once it is destroyed
+	template <typename T>
+	T *getEntity(AgentHandle handle)
+	{
+		AgentStore &store = checkType<T>().agents;
+		return store.isAlive(handle) ? static_cast<T *>(store.owner[store.rowOf(handle)]) : nullptr;
+	}
+
 	template <typename T, typename ...Args>
 	T *createEntity(Args... args)
 	{
-		std::string type = checkType<T>();
-		T *newEntity = new T(std::forward<Args>(args)...);
-		entities.at(type)[newEntity] = newEntity;
+		EntityType &type = checkType<T>();
+		T *newEntity = new (type.pool.allocate()) T(std::forward<Args>(args)...);
+		attach(type.agents, newEntity);
 		return newEntity;
 	}
 
-	template <typename ...Args>
-	Entity *createEntity(const std::string &type, Args... args)
+	template <typename T>
+	void destroyEntity(AgentHandle handle)
 	{
-		if (!entities.count(type))
-			return nullptr;
-
-		Entity *newEntity = new Entity(std::forward<Args>(args)...);
-		entities.at(type)[newEntity] = newEntity;
-		return newEntity;
+		// shouldn't crash here if deleting while iterating because the vector returned is different
+		// but might crash elsewhere if you tried to access a deleted entity
+		EntityType &type = checkType<T>();
+		crashIf(!type.agents.isAlive(handle), "Entity to delete was not found");
+		Entity *entity = type.agents.owner[type.agents.rowOf(handle)];
+		entity->onDestroy();
+		type.agents.destroy(handle);
+		entity->~Entity();
+		type.pool.release(entity);
 	}
 
 	template <typename T>
 	void destroyEntity(Entity *entity)
 	{
-		// shouldn't crash here if deleting while iterating because the vector returned is different
-		// but might crash elsewhere if you tried to access a deleted entity
-		std::string type = checkType<T>();
-		crashIf(!entities.at(type).count(entity), "Entity to delete was not found");
-		entities.at(type).at(entity)->onDestroy();
-		delete entities.at(type).at(entity);
-		entities.at(type).erase(entity);
-		//toDelete.push_back(std::make_pair(type, entity));
+		destroyEntity<T>(entity->handle);
+	}
+
+	//! makes room for count entities of a type, so creating up to that many allocates nothing
+	template <typename T>
+	void reserveEntities(size_t count)
+	{
+		EntityType &type = checkType<T>();
+		type.agents.reserve(count);
+		type.pool.reserve(count);
 	}
 
 	template <typename T>
-	bool isEntityAlive(Entity *entity)
+	bool isEntityAlive(AgentHandle handle)
 	{
-		std::string type = checkType<T>();
-		return entities.at(type).count(entity);
+		return checkType<T>().agents.isAlive(handle);
 	}
 
 	template <typename T>
@@ -234,11 +301,12 @@ public:
 	{
 		if constexpr (std::is_base_of_v<Entity, std::decay_t<T>>)
 		{
-			std::string type = typeid(T).name();
-			type = utl::trimString(type, "class ");
-			crashIf(entities.count(type), "Entity type " + utl::quote(type) + " already exists");
+			std::string name = typeid(T).name();
+			name = utl::trimString(name, "class ");
+			crashIf(typeIndex<T>() >= 0, "Entity type " + utl::quote(name) + " already exists");
 
-			entities[type] = std::unordered_map<Entity *, Entity *>();
+			typeIndex<T>() = static_cast<int>(types.size());
+			types.push_back(EntityType{ name, AgentStore(), ObjectPool(sizeof(T)) });
 			return;
 		}
 
@@ -0,0 +1,401 @@
+//==============================================================================
+/*!
+\file		FieldKernels.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the vectorized field and line of sight kernels
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "FieldKernels.h"
+#include "LineOfSight.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#include <emmintrin.h>
+#define KERNEL_SSE2
+#endif
+
+namespace
+{
+	constexpr float FMAX = std::numeric_limits<float>::max();
+
+	// ===============
+	// LANE OPERATIONS
+	// ===============
+	// thin wrappers so every kernel is written once for both instruction sets
+
+#if defined(KERNEL_AVX2)
+	using Lane = __m256;
+	constexpr size_t LANES = 8;
+
+	inline Lane load(float const *p) { return _mm256_loadu_ps(p); }
+	inline void store(float *p, Lane v) { _mm256_storeu_ps(p, v); }
+	inline Lane splat(float f) { return _mm256_set1_ps(f); }
+	inline Lane add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+	inline Lane sub(Lane a, Lane b) { return _mm256_sub_ps(a, b); }
+	inline Lane mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+	inline Lane div(Lane a, Lane b) { return _mm256_div_ps(a, b); }
+	inline Lane min(Lane a, Lane b) { return _mm256_min_ps(a, b); }
+	inline Lane max(Lane a, Lane b) { return _mm256_max_ps(a, b); }
+	inline Lane less(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	inline Lane select(Lane mask, Lane a, Lane b) { return _mm256_blendv_ps(b, a, mask); }
+
+	//! all bits set in the lanes whose wall flag is set
+	inline Lane wallMask(unsigned char const *walls)
+	{
+		__m256i flags = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(walls)));
+		return _mm256_castsi256_ps(_mm256_cmpgt_epi32(flags, _mm256_setzero_si256()));
+	}
+
+	inline float reduceMin(Lane v)
+	{
+		__m128 m = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+		return _mm_cvtss_f32(_mm_min_ss(m, _mm_shuffle_ps(m, m, 1)));
+	}
+
+	inline float reduceMax(Lane v)
+	{
+		__m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+		return _mm_cvtss_f32(_mm_max_ss(m, _mm_shuffle_ps(m, m, 1)));
+	}
+
+	// integer lanes for the line traces
+	using LaneI = __m256i;
+
+	inline LaneI splatI(int i) { return _mm256_set1_epi32(i); }
+	inline LaneI loadI(int const *p) { return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)); }
+	inline LaneI addI(LaneI a, LaneI b) { return _mm256_add_epi32(a, b); }
+	inline LaneI subI(LaneI a, LaneI b) { return _mm256_sub_epi32(a, b); }
+	inline LaneI andI(LaneI a, LaneI b) { return _mm256_and_si256(a, b); }
+	inline LaneI orI(LaneI a, LaneI b) { return _mm256_or_si256(a, b); }
+	inline LaneI andNotI(LaneI a, LaneI b) { return _mm256_andnot_si256(a, b); }	// ~a & b
+	inline LaneI lessI(LaneI a, LaneI b) { return _mm256_cmpgt_epi32(b, a); }
+	inline LaneI equalI(LaneI a, LaneI b) { return _mm256_cmpeq_epi32(a, b); }
+	inline LaneI absI(LaneI a) { return _mm256_abs_epi32(a); }
+	inline int maskOf(LaneI mask) { return _mm256_movemask_ps(_mm256_castsi256_ps(mask)); }
+
+	//! walls[index] of every lane in mask (0 elsewhere), count is the size of walls
+	inline LaneI gatherBytes(unsigned char const *walls, size_t count, LaneI index, LaneI mask)
+	{
+		// 4 bytes are read per lane, so the last lanes read from 3 bytes before and shift
+		LaneI last = splatI(static_cast<int>(count) - 4);
+		LaneI base = _mm256_blendv_epi8(index, last, _mm256_cmpgt_epi32(index, last));
+		LaneI shift = _mm256_slli_epi32(subI(index, base), 3);
+		LaneI words = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<int const *>(walls), base, mask, 1);
+		return andI(_mm256_srlv_epi32(words, shift), splatI(0xFF));
+	}
+#elif defined(KERNEL_SSE2)
+	using Lane = __m128;
+	constexpr size_t LANES = 4;
+
+	inline Lane load(float const *p) { return _mm_loadu_ps(p); }
+	inline void store(float *p, Lane v) { _mm_storeu_ps(p, v); }
+	inline Lane splat(float f) { return _mm_set1_ps(f); }
+	inline Lane add(Lane a, Lane b) { return _mm_add_ps(a, b); }
+	inline Lane sub(Lane a, Lane b) { return _mm_sub_ps(a, b); }
+	inline Lane mul(Lane a, Lane b) { return _mm_mul_ps(a, b); }
+	inline Lane div(Lane a, Lane b) { return _mm_div_ps(a, b); }
+	inline Lane min(Lane a, Lane b) { return _mm_min_ps(a, b); }
+	inline Lane max(Lane a, Lane b) { return _mm_max_ps(a, b); }
+	inline Lane less(Lane a, Lane b) { return _mm_cmplt_ps(a, b); }
+	inline Lane select(Lane mask, Lane a, Lane b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+	//! all bits set in the lanes whose wall flag is set
+	inline Lane wallMask(unsigned char const *walls)
+	{
+		int flags4{};
+		std::memcpy(&flags4, walls, sizeof(flags4));
+
+		__m128i zero = _mm_setzero_si128();
+		__m128i flags = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(flags4), zero), zero);
+		return _mm_castsi128_ps(_mm_cmpgt_epi32(flags, zero));
+	}
+
+	inline float reduceMin(Lane v)
+	{
+		v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+		return _mm_cvtss_f32(_mm_min_ss(v, _mm_shuffle_ps(v, v, 1)));
+	}
+
+	inline float reduceMax(Lane v)
+	{
+		v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+		return _mm_cvtss_f32(_mm_max_ss(v, _mm_shuffle_ps(v, v, 1)));
+	}
+
+	// integer lanes for the line traces
+	using LaneI = __m128i;
+
+	inline LaneI splatI(int i) { return _mm_set1_epi32(i); }
+	inline LaneI loadI(int const *p) { return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)); }
+	inline LaneI addI(LaneI a, LaneI b) { return _mm_add_epi32(a, b); }
+	inline LaneI subI(LaneI a, LaneI b) { return _mm_sub_epi32(a, b); }
+	inline LaneI andI(LaneI a, LaneI b) { return _mm_and_si128(a, b); }
+	inline LaneI orI(LaneI a, LaneI b) { return _mm_or_si128(a, b); }
+	inline LaneI andNotI(LaneI a, LaneI b) { return _mm_andnot_si128(a, b); }	// ~a & b
+	inline LaneI lessI(LaneI a, LaneI b) { return _mm_cmplt_epi32(a, b); }
+	inline LaneI equalI(LaneI a, LaneI b) { return _mm_cmpeq_epi32(a, b); }
+	inline int maskOf(LaneI mask) { return _mm_movemask_ps(_mm_castsi128_ps(mask)); }
+
+	inline LaneI absI(LaneI a)
+	{
+		LaneI sign = _mm_srai_epi32(a, 31);
+		return _mm_sub_epi32(_mm_xor_si128(a, sign), sign);
+	}
+
+	//! walls[index] of every lane in mask (0 elsewhere), no gather before AVX2 so the lanes are loaded one by one
+	inline LaneI gatherBytes(unsigned char const *walls, size_t, LaneI index, LaneI mask)
+	{
+		// lanes outside the mask read the first cell
+		index = andI(index, mask);
+
+		int i0 = _mm_cvtsi128_si32(index);
+		int i1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(index, 0x55));
+		int i2 = _mm_cvtsi128_si32(_mm_shuffle_epi32(index, 0xAA));
+		int i3 = _mm_cvtsi128_si32(_mm_shuffle_epi32(index, 0xFF));
+
+		return andI(_mm_set_epi32(walls[i3], walls[i2], walls[i1], walls[i0]), mask);
+	}
+#endif
+
+#if defined(KERNEL_AVX2) || defined(KERNEL_SSE2)
+	#define KERNEL_SIMD
+#endif
+
+	// dst = (src - minValue) / range, or 0 if there is no range
+	void rescale(float const *src, float *dst, size_t count, float minValue, float maxValue)
+	{
+		size_t i{};
+
+		if (!(maxValue > minValue))
+		{
+			std::fill(dst, dst + count, 0.f);
+			return;
+		}
+
+		float range = maxValue - minValue;
+
+#ifdef KERNEL_SIMD
+		Lane vMin = splat(minValue), vRange = splat(range);
+
+		for (; i + LANES <= count; i += LANES)
+			store(dst + i, div(sub(load(src + i), vMin), vRange));
+#endif
+
+		for (; i < count; ++i)
+			dst[i] = (src[i] - minValue) / range;
+	}
+}
+
+namespace kernel
+{
+	const char *getIsa()
+	{
+#if defined(KERNEL_AVX2)
+		return "AVX2";
+#elif defined(KERNEL_SSE2)
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+
+	void combine(float const *distance, float const *repulsion, float const *potential, unsigned char const *walls,
+		float potentialWeight, float *final, size_t count)
+	{
+		float minFinal = FMAX, maxFinal = -FMAX;
+		size_t i{};
+
+		// combine and find the min/ max of the non-wall cells in the same pass, walls keep their value
+#ifdef KERNEL_SIMD
+		Lane vWeight = splat(potentialWeight);
+		Lane vMin = splat(FMAX), vMax = splat(-FMAX);
+
+		for (; i + LANES <= count; i += LANES)
+		{
+			Lane isWall = wallMask(walls + i);
+			Lane combined = sub(add(load(distance + i), load(repulsion + i)), mul(load(potential + i), vWeight));
+
+			store(final + i, select(isWall, load(final + i), combined));
+			vMin = min(vMin, select(isWall, vMin, combined));
+			vMax = max(vMax, select(isWall, vMax, combined));
+		}
+
+		minFinal = reduceMin(vMin);
+		maxFinal = reduceMax(vMax);
+#endif
+
+		for (; i < count; ++i)
+		{
+			if (walls[i])
+				continue;
+
+			final[i] = distance[i] + repulsion[i] - potential[i] * potentialWeight;
+			minFinal = std::min(minFinal, final[i]);
+			maxFinal = std::max(maxFinal, final[i]);
+		}
+
+		rescale(final, final, count, minFinal, maxFinal);
+	}
+
+	float normalizeMax(float *layer, size_t count)
+	{
+		float maxValue{};
+		size_t i{};
+
+#ifdef KERNEL_SIMD
+		Lane vMax = splat(0.f);
+
+		for (; i + LANES <= count; i += LANES)
+			vMax = max(vMax, load(layer + i));
+
+		maxValue = reduceMax(vMax);
+#endif
+
+		for (; i < count; ++i)
+			maxValue = std::max(maxValue, layer[i]);
+
+		if (maxValue > 0)
+			rescale(layer, layer, count, 0.f, maxValue);
+
+		return maxValue;
+	}
+
+	float normalizeFinite(float const *src, float *dst, size_t count)
+	{
+		float maxValue{};
+		size_t i{};
+
+#ifdef KERNEL_SIMD
+		Lane vMax = splat(0.f), vUnreached = splat(FMAX);
+
+		for (; i + LANES <= count; i += LANES)
+		{
+			Lane value = load(src + i);
+			vMax = max(vMax, select(less(value, vUnreached), value, vMax));
+		}
+
+		maxValue = reduceMax(vMax);
+#endif
+
+		for (; i < count; ++i)
+			if (src[i] < FMAX)
+				maxValue = std::max(maxValue, src[i]);
+
+		if (maxValue > 0)
+			rescale(src, dst, count, 0.f, maxValue);
+		else if (src != dst)
+			std::copy(src, src + count, dst);
+
+		return maxValue;
+	}
+
+	void traceLines(int height, int width, unsigned char const *walls, int row, int col, int const *targets, size_t count, std::uint32_t *clear)
+	{
+		size_t cells = static_cast<size_t>(height) * width;
+		auto isInside = [height, width](int r, int c) { return r >= 0 && c >= 0 && r < height && c < width; };
+
+		std::fill(clear, clear + (count + 31) / 32, 0u);
+
+		auto traceOne = [&](size_t i)
+			{
+				int dr = targets[2 * i] - row, dc = targets[2 * i + 1] - col;
+				bool isClear = (!dr && !dc) || traceLine(dr, dc, [&](int r, int c)
+					{
+						return !isInside(row + r, col + c) || walls[(row + r) * width + col + c];
+					});
+
+				if (isClear)
+					clear[i / 32] |= 1u << (i % 32);
+			};
+
+		size_t i{};
+
+#ifdef KERNEL_SIMD
+		// every lane steps through its own line, lanes drop out when they arrive or hit a wall.
+		// the crossings are scaled by 2 rows cols, which has to fit in an int
+		if (isInside(row, col) && cells >= 4 && cells < INT_MAX / 4)
+		{
+			LaneI zero = splatI(0), allSet = equalI(zero, zero);
+
+			for (; i + LANES <= count; i += LANES)
+			{
+				alignas(32) int rows[LANES], cols[LANES];
+				bool isAllInside = true;
+
+				for (size_t lane{}; lane < LANES; ++lane)
+				{
+					rows[lane] = targets[2 * (i + lane)];
+					cols[lane] = targets[2 * (i + lane) + 1];
+					isAllInside = isAllInside && isInside(rows[lane], cols[lane]);
+				}
+
+				// lines leaving the grid are rare, they go through the bounds checked trace
+				if (!isAllInside)
+				{
+					for (size_t lane{}; lane < LANES; ++lane)
+						traceOne(i + lane);
+					continue;
+				}
+
+				LaneI dr = subI(loadI(rows), splatI(row)), dc = subI(loadI(cols), splatI(col));
+				LaneI isUp = lessI(dr, zero), isLeft = lessI(dc, zero);
+				LaneI rowStep = orI(andI(isUp, splatI(-width)), andNotI(isUp, splatI(width)));
+				LaneI colStep = orI(andI(isLeft, splatI(-1)), andNotI(isLeft, splatI(1)));
+
+				LaneI rowsLeft = absI(dr), colsLeft = absI(dc);
+				LaneI rowAdvance = addI(colsLeft, colsLeft), colAdvance = addI(rowsLeft, rowsLeft);
+				LaneI noCols = equalI(colsLeft, zero), noRows = equalI(rowsLeft, zero);
+				LaneI nextCol = orI(andI(noCols, splatI(INT_MAX)), andNotI(noCols, rowsLeft));
+				LaneI nextRow = orI(andI(noRows, splatI(INT_MAX)), andNotI(noRows, colsLeft));
+
+				LaneI index = splatI(row * width + col);
+				LaneI pending = andNotI(andI(noRows, noCols), allSet);
+				LaneI blocked = zero;
+
+				// blocked lanes keep stepping to their target, so the stepping never waits on the wall gathers
+				while (maskOf(andNotI(blocked, pending)))
+				{
+					LaneI colFirst = lessI(nextCol, nextRow), rowFirst = lessI(nextRow, nextCol);
+					LaneI corner = andNotI(orI(colFirst, rowFirst), pending);
+
+					// through a corner the cells beside it are touched too
+					if (maskOf(corner))
+					{
+						LaneI side = orI(gatherBytes(walls, cells, addI(index, colStep), corner), gatherBytes(walls, cells, addI(index, rowStep), corner));
+						blocked = orI(blocked, andI(corner, lessI(zero, side)));
+					}
+
+					LaneI moveCol = andNotI(rowFirst, pending), moveRow = andNotI(colFirst, pending);
+					index = addI(index, addI(andI(moveCol, colStep), andI(moveRow, rowStep)));
+					nextCol = addI(nextCol, andI(moveCol, colAdvance));
+					nextRow = addI(nextRow, andI(moveRow, rowAdvance));
+					colsLeft = addI(colsLeft, moveCol);
+					rowsLeft = addI(rowsLeft, moveRow);
+
+					pending = andNotI(andI(equalI(rowsLeft, zero), equalI(colsLeft, zero)), pending);
+					blocked = orI(blocked, andI(pending, lessI(zero, gatherBytes(walls, cells, index, pending))));
+				}
+
+				clear[i / 32] |= static_cast<std::uint32_t>(~maskOf(blocked) & ((1 << LANES) - 1)) << (i % 32);
+			}
+		}
+#endif
+
+		for (; i < count; ++i)
+			traceOne(i);
+	}
+}
@@ -0,0 +1,48 @@
+//==============================================================================
+/*!
+\file		FieldKernels.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the vectorized field and line of sight kernels
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef FIELDKERNELS_H
+#define FIELDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// the kernels use AVX2 when the compiler targets it (/arch:AVX2), SSE2 on any other
+// x86/x64 build and plain loops everywhere else. all paths give the same results
+namespace kernel
+{
+	//! instruction set the kernels were compiled for
+	const char *getIsa();
+
+	// @brief final = distance + repulsion - potential * potentialWeight for every non-wall cell,
+	//        then the whole layer (walls included) is rescaled to 0-1 by the non-wall min/ max
+	// @param count: number of cells in every layer
+	void combine(float const *distance, float const *repulsion, float const *potential, unsigned char const *walls,
+		float potentialWeight, float *final, size_t count);
+
+	// @brief divides the layer by its maximum when the maximum is positive
+	// @return the maximum
+	float normalizeMax(float *layer, size_t count);
+
+	// @brief dst = src / (largest finite value of src), unreachable cells (FLT_MAX) are divided too
+	// @return the largest finite value
+	float normalizeFinite(float const *src, float *dst, size_t count);
+
+	// @brief line of sight from (row, col) to every target, touching the same cells as traceLine with anything
+	//        outside the grid blocking. one line per lane, gathering the walls of all lanes at once
+	// @param targets: count (row, col) pairs
+	// @param clear: (count + 31) / 32 words, bit i % 32 of word i / 32 is set when target i is in sight
+	void traceLines(int height, int width, unsigned char const *walls, int row, int col, int const *targets, size_t count, std::uint32_t *clear);
+}
+
+#endif // !FIELDKERNELS_H
@@ -0,0 +1,347 @@
+//==============================================================================
+/*!
+\file		FieldSolver.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the distance field solvers
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "FieldSolver.h"
+#include "JobSystem.h"
+#include <algorithm>
+
+void BucketQueue::push(float key, int index)
+{
+	size_t bucket = bucketOf(key);
+
+	if (bucket >= buckets.size())
+		buckets.resize(bucket + 1);
+
+	// seeds may be pushed below the bucket being drained
+	if (bucket < current)
+		current = bucket;
+
+	buckets[bucket].push_back(index);
+	++count;
+}
+
+bool BucketQueue::pop(int &index)
+{
+	if (!count)
+	{
+		current = 0;
+		return false;
+	}
+
+	while (buckets[current].empty())
+		++current;
+
+	index = buckets[current].back();
+	buckets[current].pop_back();
+	--count;
+	return true;
+}
+
+bool BucketQueue::empty() const
+{
+	return !count;
+}
+
+void BucketQueue::clear()
+{
+	// keep the bucket storage around for the next solve
+	for (auto &bucket : buckets)
+		bucket.clear();
+
+	current = 0;
+	count = 0;
+}
+
+void solveField(int height, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+	std::vector<float> &dist, std::vector<int> *parent, BucketQueue &queue)
+{
+	solveTile({ 0, 0, height, width }, width, canEnter, blocksCorner, dist, parent, queue);
+}
+
+void solveTile(TileBounds const &tile, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+	std::vector<float> &dist, std::vector<int> *parent, BucketQueue &queue)
+{
+	int currIndex{};
+
+	while (queue.pop(currIndex))
+	{
+		float currDist = dist[currIndex];
+
+		// skip entries of cells that have moved to a lower bucket since
+		if (BucketQueue::bucketOf(currDist) != queue.top())
+			continue;
+
+		int row = currIndex / width, col = currIndex % width;
+
+		// check its 8 neighbour
+		for (int i{ -1 }; i <= 1; ++i)
+		{
+			if (row + i < tile.row0 || row + i >= tile.row1)
+				continue;
+
+			for (int j{ -1 }; j <= 1; ++j)
+			{
+				if ((i == 0 && j == 0) || col + j < tile.col0 || col + j >= tile.col1)
+					continue;
+
+				int neighbourIndex = currIndex + i * width + j;
+
+				if (!canEnter[neighbourIndex])
+					continue;
+
+				// skip diagonal neighbors if there's an adjacent wall
+				if (i != 0 && j != 0 && (blocksCorner[currIndex + i * width] || blocksCorner[currIndex + j]))
+					continue;
+
+				float newDistance = currDist + stepCost(i, j);
+
+				if (newDistance < dist[neighbourIndex])
+				{
+					dist[neighbourIndex] = newDistance;
+					if (parent)
+						(*parent)[neighbourIndex] = currIndex;
+					queue.push(newDistance, neighbourIndex);
+				}
+			}
+		}
+	}
+}
+
+// ==================
+// DISTANCE TRANSFORM
+// ==================
+
+namespace
+{
+	// 1D squared distance transform of f (n values, stride apart) in place
+	void transform1D(float *f, int n, int stride, std::vector<float> &values, std::vector<int> &parabolas, std::vector<float> &bounds)
+	{
+		constexpr float FAR = 1e20f;
+
+		values.resize(n);
+		parabolas.resize(n);
+		bounds.resize(n + 1);
+
+		for (int q{}; q < n; ++q)
+			values[q] = f[q * stride];
+
+		// lower envelope of the parabolas rooted at every finite value
+		int k = -1;
+
+		for (int q{}; q < n; ++q)
+		{
+			if (values[q] >= FAR)
+				continue;
+
+			float s{};
+
+			while (k >= 0)
+			{
+				int p = parabolas[k];
+				s = ((values[q] + q * q) - (values[p] + p * p)) / (2.f * (q - p));
+
+				if (s > bounds[k])
+					break;
+				--k;
+			}
+
+			++k;
+			parabolas[k] = q;
+			bounds[k] = k ? s : -FAR;
+			bounds[k + 1] = FAR;
+		}
+
+		if (k < 0)
+			return;
+
+		for (int q{}, i{}; q < n; ++q)
+		{
+			while (bounds[i + 1] < q)
+				++i;
+
+			int p = parabolas[i];
+			f[q * stride] = (q - p) * (q - p) + values[p];
+		}
+	}
+}
+
+void squaredDistanceTransform(int height, int width, std::vector<unsigned char> const &sites, std::vector<float> &out)
+{
+	constexpr float FAR = 1e20f;
+	std::vector<float> values;
+	std::vector<int> parabolas;
+	std::vector<float> bounds;
+
+	out.resize(sites.size());
+
+	for (size_t index{}; index < sites.size(); ++index)
+		out[index] = sites[index] ? 0.f : FAR;
+
+	// down the columns, then along the rows
+	for (int col{}; col < width; ++col)
+		transform1D(out.data() + col, height, width, values, parabolas, bounds);
+
+	for (int row{}; row < height; ++row)
+		transform1D(out.data() + row * width, width, 1, values, parabolas, bounds);
+
+	for (float &dist : out)
+		if (dist >= FAR)
+			dist = UNREACHED;
+}
+
+// ==================
+// TILED FIELD SOLVER
+// ==================
+
+void TiledFieldSolver::makeTiles(int height, int width)
+{
+	int rows = (height + tileSize - 1) / tileSize;
+	int cols = (width + tileSize - 1) / tileSize;
+
+	if (rows == tileRows && cols == tileCols && tiles.size() && tiles.back().bounds.row1 == height && tiles.back().bounds.col1 == width)
+		return;
+
+	tileRows = rows;
+	tileCols = cols;
+	tiles.clear();
+	tiles.resize(rows * cols);
+
+	for (int row{}; row < rows; ++row)
+		for (int col{}; col < cols; ++col)
+			tiles[row * cols + col].bounds = { row * tileSize, col * tileSize,
+				std::min(height, (row + 1) * tileSize), std::min(width, (col + 1) * tileSize) };
+}
+
+void TiledFieldSolver::pullBorder(Tile &tile, int height, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+	std::vector<float> const &dist)
+{
+	TileBounds const &b = tile.bounds;
+
+	auto pullCell = [&](int row, int col)
+		{
+			int index = row * width + col;
+
+			if (!canEnter[index])
+				return;
+
+			Update best{ index, dist[index], -1 };
+
+			for (int i{ -1 }; i <= 1; ++i)
+				for (int j{ -1 }; j <= 1; ++j)
+				{
+					int fromRow = row + i, fromCol = col + j;
+
+					// only cells of the other tiles
+					if (fromRow < 0 || fromRow >= height || fromCol < 0 || fromCol >= width ||
+						(fromRow >= b.row0 && fromRow < b.row1 && fromCol >= b.col0 && fromCol < b.col1))
+						continue;
+
+					int from = fromRow * width + fromCol;
+
+					if (dist[from] == UNREACHED)
+						continue;
+
+					// the step goes from the neighbour into this cell
+					if (i != 0 && j != 0 && (blocksCorner[from - i * width] || blocksCorner[from - j]))
+						continue;
+
+					float newDistance = dist[from] + stepCost(i, j);
+
+					if (newDistance < best.dist)
+						best = { index, newDistance, from };
+				}
+
+			if (best.from != -1)
+				tile.pending.push_back(best);
+		};
+
+	for (int col{ b.col0 }; col < b.col1; ++col)
+	{
+		pullCell(b.row0, col);
+		if (b.row1 - 1 != b.row0)
+			pullCell(b.row1 - 1, col);
+	}
+
+	for (int row{ b.row0 + 1 }; row < b.row1 - 1; ++row)
+	{
+		pullCell(row, b.col0);
+		if (b.col1 - 1 != b.col0)
+			pullCell(row, b.col1 - 1);
+	}
+}
+
+void TiledFieldSolver::solve(int height, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+	std::vector<float> &dist, std::vector<int> *parent, JobSystem &jobs)
+{
+	makeTiles(height, width);
+
+	// seed every tile with the sources inside it
+	jobs.parallelFor(static_cast<int>(tiles.size()), [&](int t)
+		{
+			Tile &tile = tiles[t];
+			tile.queue.clear();
+			tile.pending.clear();
+
+			for (int row{ tile.bounds.row0 }; row < tile.bounds.row1; ++row)
+				for (int col{ tile.bounds.col0 }; col < tile.bounds.col1; ++col)
+					if (dist[row * width + col] != UNREACHED)
+						tile.queue.push(dist[row * width + col], row * width + col);
+		});
+
+	bool hasPending{ true };
+
+	while (hasPending)
+	{
+		// solve the tiles that got new distances, each tile only writes its own cells
+		jobs.parallelFor(static_cast<int>(tiles.size()), [&](int t)
+			{
+				Tile &tile = tiles[t];
+
+				for (Update const &update : tile.pending)
+					if (update.dist < dist[update.index])
+					{
+						dist[update.index] = update.dist;
+						if (parent)
+							(*parent)[update.index] = update.from;
+						tile.queue.push(update.dist, update.index);
+					}
+
+				tile.pending.clear();
+				tile.isSolved = !tile.queue.empty();
+
+				if (tile.isSolved)
+					solveTile(tile.bounds, width, canEnter, blocksCorner, dist, parent, tile.queue);
+			});
+
+		// pull across the borders of tiles next to a solved one, dist is only read here
+		jobs.parallelFor(static_cast<int>(tiles.size()), [&](int t)
+			{
+				int tileRow = t / tileCols, tileCol = t % tileCols;
+				bool isNextToSolved{ false };
+
+				for (int i{ -1 }; i <= 1 && !isNextToSolved; ++i)
+					for (int j{ -1 }; j <= 1; ++j)
+						if ((i || j) && tileRow + i >= 0 && tileRow + i < tileRows && tileCol + j >= 0 && tileCol + j < tileCols &&
+							tiles[(tileRow + i) * tileCols + tileCol + j].isSolved)
+						{
+							isNextToSolved = true;
+							break;
+						}
+
+				if (isNextToSolved)
+					pullBorder(tiles[t], height, width, canEnter, blocksCorner, dist);
+			});
+
+		hasPending = std::any_of(tiles.begin(), tiles.end(), [](Tile const &tile) { return tile.pending.size(); });
+	}
+}
@@ -0,0 +1,110 @@
+//==============================================================================
+/*!
+\file		FieldSolver.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the distance field solvers
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef FIELDSOLVER_H
+#define FIELDSOLVER_H
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+
+// octile step costs
+constexpr float ORTH_COST = 1.f;
+constexpr float DIAG_COST = 1.41421356f;
+constexpr float UNREACHED = std::numeric_limits<float>::max();
+
+//! cost of a single step to one of the 8 neighbours
+inline float stepCost(int i, int j) { return i && j ? DIAG_COST : ORTH_COST; }
+
+// monotone priority queue for distance fields. every bucket is one unit wide, which
+// is never more than the cheapest step, so once a bucket is reached nothing still
+// queued can improve the cells inside it and their distances are exact
+class BucketQueue
+{
+	std::vector<std::vector<int>> buckets;
+	size_t current{};	// lowest bucket that may still hold entries
+	size_t count{};		// number of queued entries (stale ones included)
+
+public:
+
+	//! bucket a distance falls into
+	static size_t bucketOf(float key) { return static_cast<size_t>(key); }
+
+	//! queue a cell with its tentative distance
+	void push(float key, int index);
+
+	//! take a cell from the lowest bucket, false if the queue is empty
+	bool pop(int &index);
+
+	//! bucket the last popped cell came from
+	size_t top() const { return current; }
+
+	bool empty() const;
+	void clear();
+};
+
+// half-open block of cells [row0, row1) x [col0, col1)
+struct TileBounds { int row0{}, col0{}, row1{}, col1{}; };
+
+// relaxes dist (and parent if given) from every cell in the queue until it is empty.
+// canEnter marks the cells a step may end in and blocksCorner the cells that stop a
+// diagonal step from squeezing past them
+void solveField(int height, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+	std::vector<float> &dist, std::vector<int> *parent, BucketQueue &queue);
+
+//! same as solveField but steps never leave the tile
+void solveTile(TileBounds const &tile, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+	std::vector<float> &dist, std::vector<int> *parent, BucketQueue &queue);
+
+// @brief exact squared euclidean distance (in cells) from every cell to the nearest site,
+//        separable lower envelope of parabolas (Felzenszwalb & Huttenlocher), O(cells)
+// @param sites: non-zero for the cells distances are measured to
+// @param out: UNREACHED everywhere if there are no sites
+void squaredDistanceTransform(int height, int width, std::vector<unsigned char> const &sites, std::vector<float> &out);
+
+class JobSystem;
+
+// splits the grid into tiles that are solved on the job system. tiles are solved on
+// their own, then pull improved distances across their borders from the neighbouring
+// tiles, and this repeats until no border changes, so the result is the same field
+// solveField gives (up to float rounding of equally short paths)
+class TiledFieldSolver
+{
+	// border improvement found for a cell while the neighbouring tiles were read
+	struct Update { int index; float dist; int from; };
+
+	struct Tile
+	{
+		TileBounds bounds;
+		BucketQueue queue;
+		std::vector<Update> pending;
+		bool isSolved{ false };		// was solved in the current round
+	};
+
+	std::vector<Tile> tiles;
+	int tileRows{}, tileCols{};
+
+	void makeTiles(int height, int width);
+	void pullBorder(Tile &tile, int height, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+		std::vector<float> const &dist);
+
+public:
+
+	int tileSize{ 64 };	// rows and columns per tile
+
+	//! solve dist from the cells it already has a distance for (the sources)
+	void solve(int height, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner,
+		std::vector<float> &dist, std::vector<int> *parent, JobSystem &jobs);
+};
+
+#endif // !FIELDSOLVER_H
@@ -0,0 +1,76 @@
+//==============================================================================
+/*!
+\file		FlowFieldCache.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the least recently used flow field cache
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "FlowFieldCache.h"
+#include <iterator>
+
+FlowFieldCache::Field const *FlowFieldCache::find(Key const &key)
+{
+	auto it = lookup.find(key);
+
+	if (it == lookup.end())
+	{
+		++misses;
+		return nullptr;
+	}
+
+	++hits;
+	entries.splice(entries.begin(), entries, it->second);
+	return &it->second->field;
+}
+
+void FlowFieldCache::insert(Key const &key, std::vector<float> const &distance, std::vector<float> const &final)
+{
+	// versions only go up, so nothing solved for older walls is asked for again
+	for (auto it = entries.begin(); it != entries.end();)
+	{
+		auto next = std::next(it);
+
+		if (it->key == key || it->key.wallVersion != key.wallVersion || it->key.knownWallVersion != key.knownWallVersion)
+			erase(it);
+
+		it = next;
+	}
+
+	entries.push_front({ key, { distance, final } });
+	lookup[key] = entries.begin();
+	bytes += getBytes(entries.front());
+
+	trim();
+}
+
+void FlowFieldCache::clear()
+{
+	entries.clear();
+	lookup.clear();
+	bytes = 0;
+}
+
+size_t FlowFieldCache::getBytes(Entry const &entry)
+{
+	return (entry.field.distance.size() + entry.field.final.size()) * sizeof(float);
+}
+
+void FlowFieldCache::erase(std::list<Entry>::iterator it)
+{
+	bytes -= getBytes(*it);
+	lookup.erase(it->key);
+	entries.erase(it);
+}
+
+void FlowFieldCache::trim()
+{
+	// the newest field is kept even if it alone is over the budget, it is the one in use
+	while (bytes > budget && entries.size() > 1)
+		erase(std::prev(entries.end()));
+}
@@ -0,0 +1,91 @@
+//==============================================================================
+/*!
+\file		FlowFieldCache.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the least recently used flow field cache
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef FLOWFIELDCACHE_H
+#define FLOWFIELDCACHE_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+#include <functional>
+
+// solved goal fields kept for reuse, keyed by the goal cell and the wall versions they were solved for. the exit
+// field and the group fields go around the same known walls, so they share entries. past the memory budget the
+// least recently used ones are dropped
+class FlowFieldCache
+{
+public:
+
+	struct Key
+	{
+		int goal{ -1 };					// goal cell index
+		unsigned wallVersion{};			// walls the field was solved for
+		unsigned knownWallVersion{};	// walls the enemies knew about
+
+		bool operator==(Key const &rhs) const
+		{
+			return goal == rhs.goal && wallVersion == rhs.wallVersion && knownWallVersion == rhs.knownWallVersion;
+		}
+	};
+
+	// layers of a solved field
+	struct Field
+	{
+		std::vector<float> distance;	// raw distance to the goal
+		std::vector<float> final;		// normalized, what the directions are generated from
+	};
+
+	size_t budget{ 64u << 20 };			// bytes of fields kept
+
+	//! field solved for key, nullptr on a miss. a hit becomes the most recently used
+	Field const *find(Key const &key);
+
+	//! keeps a copy of a solved field, fields for older walls are dropped since they can not be hit again.
+	//! group fields only have a distance, final stays empty
+	void insert(Key const &key, std::vector<float> const &distance, std::vector<float> const &final = {});
+
+	void clear();
+
+	size_t getSize() const { return entries.size(); }
+	size_t getBytes() const { return bytes; }
+	size_t getHits() const { return hits; }
+	size_t getMisses() const { return misses; }
+
+private:
+
+	struct KeyHash
+	{
+		size_t operator()(Key const &key) const
+		{
+			return std::hash<int>{}(key.goal) ^ std::hash<unsigned>{}(key.wallVersion) * 31u ^ std::hash<unsigned>{}(key.knownWallVersion) * 961u;
+		}
+	};
+
+	struct Entry
+	{
+		Key key;
+		Field field;
+	};
+
+	std::list<Entry> entries;			// most recently used first
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup;
+	size_t bytes{};
+	size_t hits{}, misses{};
+
+	static size_t getBytes(Entry const &entry);
+	void erase(std::list<Entry>::iterator it);
+	void trim();
+};
+
+#endif // !FLOWFIELDCACHE_H
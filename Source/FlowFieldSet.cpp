@@ -0,0 +1,184 @@
+//==============================================================================
+/*!
+\file		FlowFieldSet.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the per group flow fields
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "FlowFieldSet.h"
+#include "JobSystem.h"
+
+void FlowFieldSet::setLayers(int _height, int _width, std::vector<unsigned char> const &_canEnter, std::vector<unsigned char> const &_blocksCorner)
+{
+	height = _height;
+	width = _width;
+	canEnter = _canEnter;
+	blocksCorner = _blocksCorner;
+
+	for (Field &field : fields)
+		field.isSolved = false;
+}
+
+void FlowFieldSet::setGoal(int group, int goal)
+{
+	if (group < 0)
+		return;
+
+	if (group >= static_cast<int>(fields.size()))
+		fields.resize(group + 1);
+
+	if (fields[group].goal == goal)
+		return;
+
+	fields[group].goal = goal;
+	fields[group].isSolved = false;
+}
+
+bool FlowFieldSet::isGoalValid(int goal) const
+{
+	return goal >= 0 && goal < height * width && canEnter[goal];
+}
+
+int FlowFieldSet::getGoal(int group) const
+{
+	return group >= 0 && group < static_cast<int>(fields.size()) ? fields[group].goal : -1;
+}
+
+void FlowFieldSet::update(JobSystem &jobs, FlowFieldCache &cache, unsigned wallVersion, unsigned knownWallVersion)
+{
+	stale.clear();
+	copies.clear();
+
+	for (int group{}; group < static_cast<int>(fields.size()); ++group)
+	{
+		if (fields[group].isSolved)
+			continue;
+
+		// groups sent to the same goal share one solve, the field is copied from a group that is already
+		// solved for the goal or from the first stale one
+		int source{ -1 };
+
+		for (int other{}; other < static_cast<int>(fields.size()) && source < 0; ++other)
+			if (fields[other].isSolved && fields[other].goal == fields[group].goal)
+				source = other;
+
+		for (size_t k{}; k < stale.size() && source < 0; ++k)
+			if (fields[stale[k]].goal == fields[group].goal)
+				source = stale[k];
+
+		if (source < 0)
+			stale.push_back(group);
+		else
+			copies.push_back({ group, source });
+	}
+
+	if (stale.empty() && copies.empty())
+		return;
+
+	// goals solved for these walls before, by a group or the exit field, are taken from the cache
+	size_t solving{};
+
+	for (int group : stale)
+	{
+		Field &field = fields[group];
+		FlowFieldCache::Field const *cached = isGoalValid(field.goal) ? cache.find({ field.goal, wallVersion, knownWallVersion }) : nullptr;
+
+		if (cached)
+		{
+			field.dist = cached->distance;
+			field.isSolved = true;
+		}
+		else
+			stale[solving++] = group;
+	}
+
+	stale.resize(solving);
+
+	// the layers are only read, every group writes its own field and queue
+	jobs.parallelFor(static_cast<int>(stale.size()), [this](int job)
+		{
+			Field &field = fields[stale[job]];
+			field.isSolved = true;
+
+			if (!isGoalValid(field.goal))
+			{
+				field.dist.clear();
+				return;
+			}
+
+			field.dist.assign(height * width, UNREACHED);
+			field.dist[field.goal] = 0.f;
+			field.queue.clear();
+			field.queue.push(0.f, field.goal);
+			solveField(height, width, canEnter, blocksCorner, field.dist, nullptr, field.queue);
+		});
+
+	// the cache is not shared with the jobs, so the new fields go in after them
+	for (int group : stale)
+		if (isGoalValid(fields[group].goal))
+			cache.insert({ fields[group].goal, wallVersion, knownWallVersion }, fields[group].dist);
+
+	for (auto const &[group, source] : copies)
+	{
+		fields[group].dist = fields[source].dist;
+		fields[group].isSolved = true;
+	}
+}
+
+Vec2 FlowFieldSet::getDirection(int group, int row, int col) const
+{
+	if (group < 0 || group >= static_cast<int>(fields.size()) || row < 0 || col < 0 || row >= height || col >= width)
+		return {};
+
+	Field const &field = fields[group];
+	int index = row * width + col;
+
+	if (!field.isSolved || field.dist.empty() || field.dist[index] == UNREACHED || index == field.goal)
+		return {};
+
+	// follow the neighbour the distance came from
+	float best = UNREACHED;
+	Vec2 step{};
+
+	for (int i{ -1 }; i <= 1; ++i)
+	{
+		if (row + i < 0 || row + i >= height)
+			continue;
+
+		for (int j{ -1 }; j <= 1; ++j)
+		{
+			if ((i == 0 && j == 0) || col + j < 0 || col + j >= width)
+				continue;
+
+			int neighbour = index + i * width + j;
+
+			if (!canEnter[neighbour] || field.dist[neighbour] == UNREACHED)
+				continue;
+
+			// skip diagonal neighbors if there's an adjacent wall
+			if (i != 0 && j != 0 && (blocksCorner[index + i * width] || blocksCorner[index + j]))
+				continue;
+
+			float dist = field.dist[neighbour] + stepCost(i, j);
+
+			if (dist < best)
+			{
+				best = dist;
+				step = Vec2(static_cast<float>(j), static_cast<float>(i));
+			}
+		}
+	}
+
+	return step;
+}
+
+void FlowFieldSet::clear()
+{
+	fields.clear();
+}
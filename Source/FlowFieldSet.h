@@ -0,0 +1,73 @@
+//==============================================================================
+/*!
+\file		FlowFieldSet.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the per group flow fields
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef FLOWFIELDSET_H
+#define FLOWFIELDSET_H
+
+#include "Vector2D.h"
+#include "FieldSolver.h"
+#include "FlowFieldCache.h"
+#include <vector>
+#include <utility>
+
+class JobSystem;
+
+// one flow field per agent group, each to its own goal. every group is solved over the same step layers,
+// and the groups whose goal or layers changed are solved together on the job system, once per goal
+class FlowFieldSet
+{
+	struct Field
+	{
+		int goal{ -1 };					// goal cell, -1 for none
+		bool isSolved{ false };
+		std::vector<float> dist;		// distance to the goal
+		BucketQueue queue;				// per group so groups can be solved at the same time
+	};
+
+	int height{}, width{};
+	std::vector<unsigned char> canEnter, blocksCorner;	// shared by every group
+	std::vector<Field> fields;			// by group
+	std::vector<int> stale;				// scratch list of the groups to solve
+	std::vector<std::pair<int, int>> copies;	// scratch list of the groups that take the field of a group with their goal
+
+	//! a goal a field can be solved to, inside the grid and not in a known wall
+	bool isGoalValid(int goal) const;
+
+public:
+
+	// @brief takes the step layers every group is solved over, all groups are solved again on the next update
+	// @param canEnter: cells a step may end in
+	// @param blocksCorner: cells a diagonal step may not squeeze past
+	void setLayers(int height, int width, std::vector<unsigned char> const &canEnter, std::vector<unsigned char> const &blocksCorner);
+
+	//! moves the goal of a group (added if new), -1 clears it. solved on the next update
+	void setGoal(int group, int goal);
+
+	int getGoal(int group) const;
+
+	// @brief solves every group whose goal or layers changed since it was last solved, in parallel. groups with the
+	//        same goal are solved once and goals already in the cache are not solved at all
+	// @param cache: solved distances by goal and wall versions, the new ones are added to it
+	// @param wallVersion, knownWallVersion: walls the current layers were built from
+	void update(JobSystem &jobs, FlowFieldCache &cache, unsigned wallVersion, unsigned knownWallVersion);
+
+	// @brief step (-1 to 1 in x and y) toward the goal of a group
+	// @return zero for unknown or unsolved groups, the goal and cells that can not reach it
+	Vec2 getDirection(int group, int row, int col) const;
+
+	int getGroupCount() const { return static_cast<int>(fields.size()); }
+
+	void clear();
+};
+
+#endif // !FLOWFIELDSET_H
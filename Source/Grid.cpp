@@ -16,7 +16,10 @@ written consent of DigiPen Institute of Technology is prohibited.
 #include "Loader.h"
 #include "Camera.h"
 #include "Factory.h"
+#include "JobSystem.h"
+#include "FieldKernels.h"
 #include <algorithm>
+#include <cmath>
 #include <random>
 #include <stack>
 
@@ -26,6 +29,7 @@ extern Loader loader;
 extern Camera camera;
 extern DrawMode mode;
 extern float dt;
+extern JobSystem jobs;
 
 std::random_device rd;
 std::mt19937 g(rd());
@@ -62,32 +66,9 @@ void drawArrow(sf::RenderWindow& window, Vec2 const& start, Vec2 const& directio
 
 
 Grid::Grid(int _height, int _width, float _cellSize)
-	: height{ _height }, width{ _width }, cellSize { _cellSize }, cells{ static_cast<size_t>(height), std::vector<Cell>{ static_cast<size_t>(width) } }
-	, flowField{ static_cast<size_t>(height), std::vector<flowFieldCell>{ static_cast<size_t>(width) } }
-	, potentialField{ static_cast<size_t>(height), std::vector<potentialFieldCell>{ static_cast<size_t>(width)} }
+	: height{ 0 }, width{ 0 }, cellSize { _cellSize }
 {
-
-	for (int row{}; row < height; ++row)
-	{
-		for (int col{}; col < width; ++col)
-		{
-			cells[row][col].rect.setOrigin(cellSize / 2.f, cellSize / 2.f);
-			cells[row][col].rect.setSize(sf::Vector2f(cellSize, cellSize));
-			cells[row][col].rect.setPosition(col * cellSize, row * cellSize); // was row *, col *
-			cells[row][col].rect.setFillColor(colors.at("Floor").first);
-			cells[row][col].rect.setOutlineColor(colors.at("Floor").second);
-			cells[row][col].rect.setOutlineThickness(4.f);
-			cells[row][col].pos = { row, col };
-
-			// flow field
-			flowField[row][col].position = { row, col };
-			
-			// potential field
-			potentialField[row][col].direction = { 0, 0 };
-			potentialField[row][col].potential = 0;
-			potentialField[row][col].position = { row, col };
-		}
-	}
+	resize(_height, _width);
 }
 
 // ======
@@ -104,12 +85,13 @@ void Grid::render(sf::RenderWindow& window)
 	{
 		for (int col{}; col < width; ++col)
 		{
-			Cell& currCell = cells[row][col];
+			int index = getIndex(row, col);
+			Cell& currCell = cells[index];
 
 			// if cell is a wall but it has been explored before
-			if (isWall(row, col))
+			if (walls[index])
 			{
-				if (currCell.visibility != UNEXPLORED || mode != DrawMode::NONE)
+				if (visibility[index] != UNEXPLORED || mode != DrawMode::NONE)
 				{
 					currCell.rect.setFillColor(colors.at("Wall").first);
 					currCell.rect.setOutlineColor(colors.at("Wall").second);
@@ -143,7 +125,7 @@ void Grid::render(sf::RenderWindow& window)
 			}
 
 
-			switch (cells[row][col].visibility)
+			switch (visibility[index])
 			{
 			case UNEXPLORED:
 				// Black colour as unexplored colour
@@ -184,7 +166,7 @@ void Grid::render(sf::RenderWindow& window)
 
 			if (showHeatMap)
 			{
-				float value = flowField[row][col].distance;
+				float value = distance[index];
 
 				float normalizedDistance = std::min(1.f, value); // Assuming max distance of 300 for normalization
 
@@ -204,17 +186,16 @@ void Grid::render(sf::RenderWindow& window)
 			// Checking if the cell is not a wall and has a valid direction
 			if (flowFieldArrow)
 			{
-				if (!(utl::isEqual(flowField[row][col].final, 0.f)))
+				if (isSectorFlowField() || !(utl::isEqual(final[index], 0.f)))
 				{
 					Vec2 cellCenter = getWorldPos(row, col);
-					Vec2 direction = flowField[row][col].direction;
-					drawArrow(window, cellCenter, direction);
+					drawArrow(window, cellCenter, getFlowFieldDir(row, col));
 				}
 			}
 
 			if (pConfig.showPotentialField)
 			{
-				float value = flowField[row][col].potential;
+				float value = potential[index];
 
 				float normalizedDistance = value; // Assuming max distance of 300 for normalization
 
@@ -225,14 +206,14 @@ void Grid::render(sf::RenderWindow& window)
 				sf::Uint8 alpha = static_cast<sf::Uint8>((normalizedDistance) * 255);
 
 				sf::Color color = sf::Color(0, 0, 255, alpha); // Red color with varying alpha
-				cells[row][col].rect.setFillColor(color);
+				currCell.rect.setFillColor(color);
 
-				window.draw(cells[row][col].rect);
+				window.draw(currCell.rect);
 			}
 
 			if (rConfig.showRepulsionMap)
 			{
-				float value = flowField[row][col].repulsion;
+				float value = repulsion[index];
 
 				float normalizedDistance = value / 2.f; // Assuming max distance of 300 for normalization
 
@@ -250,7 +231,7 @@ void Grid::render(sf::RenderWindow& window)
 
 			if (pConfig.showFinalMap)
 			{
-				float value = flowField[row][col].final;
+				float value = final[index];
 
 				float normalizedDistance = std::min(1.f, value); // Assuming max distance of 300 for normalization
 
@@ -275,8 +256,8 @@ void Grid::render(sf::RenderWindow& window)
 
 			std::ostringstream ss;
 
-			//ss << std::fixed << (int)flowField[row][col].direction.x << " " << (int)flowField[row][col].direction.y;
-			ss << std::fixed << std::setprecision(2) << flowField[row][col].distance;
+			//ss << std::fixed << (int)direction[index].x << " " << (int)direction[index].y;
+			ss << std::fixed << std::setprecision(2) << distance[index];
 
 			text.setString(ss.str());
 
@@ -285,7 +266,7 @@ void Grid::render(sf::RenderWindow& window)
 			// Center the text in the cell
 			sf::FloatRect textRect = text.getLocalBounds();
 			text.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
-			text.setPosition(cells[row][col].rect.getPosition());
+			text.setPosition(currCell.rect.getPosition());
 
 			// Draw the text
 			window.draw(text);
@@ -312,115 +293,37 @@ void Grid::updateVisibility(std::vector<std::pair<Vec2, Vec2>> const& entities,
 	// Convert angle from degrees to radians
 	float fovAngle = fovAngleDegrees * (PI / 180.0f);
 
-	// Set all cells that are explored to FOG
-	for (int row = 0; row < height; ++row)
+	// wall edits can turn seen walls into floors that have to be demoted too, so rescan after them
+	if (visionWallVersion != wallVersion)
 	{
-		for (int col = 0; col < width; ++col)
-		{
-			// Skip wall cells
-			if (isWall(row, col))
-				continue;
-
-			if (cells[row][col].visibility != UNEXPLORED)
-				cells[row][col].visibility = FOG;
-		}
+		collectVisibleCells();
+		visionWallVersion = wallVersion;
 	}
 
+	// cells seen this update are stamped with the generation, the ones seen last update are kept to demote afterwards
+	++visionGeneration;
+	visibilityChanges.clear();
+	previousVisibleCells.swap(visibleCells);
+	visibleCells.clear();
+
+	float halfAngle = fovAngle / 2.0f;
+
+	fovFan.build(getVisionReach(cellSize, fovRadius, visionCircleRadius));
+
 	// For all entities in the vector
 	for (const auto& entity : entities)
 	{
 		Vec2 p = entity.first;
 		Vec2 direction = entity.second;
 
-		GridPos gridpos = getGridPos(p);
-
-		int startRow = std::max(0, gridpos.row - static_cast<int>(fovRadius / cellSize));
-		int endRow = std::min(height - 1, gridpos.row + static_cast<int>(fovRadius / cellSize));
-
-		int startCol = std::max(0, gridpos.col - static_cast<int>(fovRadius / cellSize));
-		int endCol = std::min(width - 1, gridpos.col + static_cast<int>(fovRadius / cellSize));
-
 		// Calculate the angle of the direction vector
 		float directionAngle = atan2(direction.y, direction.x);
-		float halfAngle = fovAngle / 2.0f;
 
-		// Update visibility based on FOV
-		for (int r = startRow; r <= endRow; ++r)
-		{
-			for (int c = startCol; c <= endCol; ++c)
-			{
-				Vec2 cellCenter = getWorldPos(r, c);
-				Vec2 directionToCell = cellCenter - p;
-				float distance = directionToCell.Distance(Vec2(0, 0));
-
-				if (distance <= fovRadius)
-				{
-					// Calculate the angle between the direction vector and the vector to the cell
-					float cellAngle = atan2(directionToCell.y, directionToCell.x);
-					float relativeAngle = cellAngle - directionAngle;
-
-					// Normalize the angle to the range [-PI, PI]
-					if (relativeAngle > PI) relativeAngle -= 2 * PI;
-					if (relativeAngle < -PI) relativeAngle += 2 * PI;
-
-					// Check if the cell is within the vision cone
-					if (fabs(relativeAngle) <= halfAngle)
-					{
-						if (!isClearPath(gridpos, GridPos{ r, c }))
-							continue;
-
-						if (cells[r][c].isExit)
-						{
-							exitFound = true;
-						}
-
-						cells[r][c].visibility = VISIBLE;
-
-						if (!isWall(r, c))
-						{
-							cells[r][c].rect.setFillColor(colors.at("Visible").first);
-							cells[r][c].rect.setOutlineColor(colors.at("Visible").second);
-						}
-					}
-				}
-			}
-		}
-
-		// Update visibility based on vision circle
-		int visionStartRow = std::max(0, gridpos.row - static_cast<int>(visionCircleRadius / cellSize));
-		int visionEndRow = std::min(height - 1, gridpos.row + static_cast<int>(visionCircleRadius / cellSize));
-
-		int visionStartCol = std::max(0, gridpos.col - static_cast<int>(visionCircleRadius / cellSize));
-		int visionEndCol = std::min(width - 1, gridpos.col + static_cast<int>(visionCircleRadius / cellSize));
-
-		for (int r = visionStartRow; r <= visionEndRow; ++r)
-		{
-			for (int c = visionStartCol; c <= visionEndCol; ++c)
+		// one sweep over the precomputed rays for the cone and the circle
+		castVision(fovFan, height, width, walls.data(), cellSize, p, direction, fovRadius, halfAngle, visionCircleRadius, [this](int row, int col)
 			{
-				Vec2 cellCenter = getWorldPos(r, c);
-				Vec2 directionToCell = cellCenter - p;
-				float distance = directionToCell.Distance(Vec2(0, 0));
-
-				if (distance <= visionCircleRadius)
-				{
-					if (!isClearPath(gridpos, GridPos{ r, c }))
-						continue;
-
-					if (cells[r][c].isExit)
-					{
-						exitFound = true;
-					}
-
-					cells[r][c].visibility = VISIBLE;
-
-					if (!isWall(r, c))
-					{
-						cells[r][c].rect.setFillColor(colors.at("Visible").first);
-						cells[r][c].rect.setOutlineColor(colors.at("Visible").second);
-					}
-				}
-			}
-		}
+				revealCell(getIndex(row, col));
+			});
 
 		// Debug draw if enabled
 		if (debugDrawRadius)
@@ -469,6 +372,19 @@ void Grid::updateVisibility(std::vector<std::pair<Vec2, Vec2>> const& entities,
 			debugRadius.push_back(std::move(innerCircle));
 		}
 	}
+
+	// only the cells that left view go back to FOG (walls stay as they are)
+	for (int index : previousVisibleCells)
+	{
+		if (seenGeneration[index] == visionGeneration || walls[index] || visibility[index] != VISIBLE)
+			continue;
+
+		visibility[index] = FOG;
+		visibilityChanges.push_back(index);
+	}
+
+	for (int index : visibilityChanges)
+		recordChange(changes.visibility, index);
 }
 
 
@@ -476,6 +392,54 @@ void Grid::updateVisibility(std::vector<std::pair<Vec2, Vec2>> const& entities,
 
 
 
+void Grid::revealCell(int index)
+{
+	// already seen by another entity
+	if (seenGeneration[index] == visionGeneration)
+		return;
+
+	seenGeneration[index] = visionGeneration;
+
+	if (visibility[index] != VISIBLE)
+		visibilityChanges.push_back(index);
+
+	if (!walls[index])
+		visibleCells.push_back(index);
+
+	if (cells[index].isExit)
+	{
+		exitFound = true;
+	}
+
+	if (visibility[index] == UNEXPLORED)
+		markUnexplored(index);
+
+	visibility[index] = VISIBLE;
+	patchStepLayers(index);
+
+	if (!walls[index])
+	{
+		cells[index].rect.setFillColor(colors.at("Visible").first);
+		cells[index].rect.setOutlineColor(colors.at("Visible").second);
+	}
+}
+
+void Grid::collectVisibleCells()
+{
+	seenGeneration.assign(visibility.size(), 0);
+	visionGeneration = 0;
+	visibleCells.clear();
+
+	for (int index{}; index < static_cast<int>(visibility.size()); ++index)
+		if (!walls[index] && visibility[index] == VISIBLE)
+			visibleCells.push_back(index);
+}
+
+const std::vector<int> &Grid::getVisibilityChanges() const
+{
+	return visibilityChanges;
+}
+
 void Grid::updateHeatMap(Vec2 target)
 {
 	// get target pos in gridPos
@@ -488,540 +452,636 @@ void Grid::updateHeatMap(Vec2 target)
 	// reset the map first
 	resetHeatMap();
 
-
 	// initialize target cell
-	flowField[targetPos.row][targetPos.col].distance = 0.f;
-	flowField[targetPos.row][targetPos.col].visited = true;
+	int targetIndex = getIndex(targetPos);
+	distance[targetIndex] = 0.f;
 
-	// push target node into openlist
-	openList.push(&flowField[targetPos.row][targetPos.col]);
+	updateStepLayers();
 
-	while (!openList.empty())
+	if (parallelHeatMap)
+		tiledSolver.solve(height, width, knownCanEnter, blocksCorner, distance, nullptr, jobs);
+	else
 	{
-		flowFieldCell& currCell = *openList.front();
+		heatQueue.push(0.f, targetIndex);
+		solveField(height, width, knownCanEnter, blocksCorner, distance, nullptr, heatQueue);
+	}
+}
 
-		openList.pop();
+void Grid::updateHeatMap()
+{
+	// nothing is reset, the raw heat layer is kept between frames, a repair clears the scratch flags it set
+	// and the normalize below and CombineMaps overwrite the distance and final layers
+	if (!incrementalHeatMap || rebuildHeatMap)
+		rebuildHeat();
+	else if (heatChanges.size())
+		repairHeat();
 
-		// check its 8 neighour
-		for (int i{ -1 }; i <= 1; ++i)
-		{
-			for (int j{ -1 }; j <= 1; ++j)
-			{
-				// skip self cell
-				if (i == 0 && j == 0)
-					continue;
+	heatChanges.clear();
+	rebuildHeatMap = false;
 
-				// create neighour position
-				GridPos neighbourPos{ currCell.position.row + i, currCell.position.col + j };
+	kernel::normalizeFinite(heat.data(), distance.data(), heat.size());
+}
 
-				// skip out of bound and wall cells
-				if (isOutOfBound(neighbourPos) || isWall(neighbourPos) && cells[neighbourPos.row][neighbourPos.col].visibility != UNEXPLORED)
-					continue;
+void Grid::updateExitField(Vec2 target)
+{
+	GridPos targetPos = getGridPos(target);
 
-				// skip diagonal neighbors if there's an adjacent wall
-				if (i != 0 && j != 0)
-				{
-					GridPos adjacent1{ currCell.position.row + i, currCell.position.col };
-					GridPos adjacent2{ currCell.position.row, currCell.position.col + j };
-					if (isOutOfBound(adjacent1) || isOutOfBound(adjacent2) || isWall(adjacent1) && cells[adjacent1.row][adjacent1.col].visibility != UNEXPLORED || isWall(adjacent2) && cells[adjacent2.row][adjacent2.col].visibility)
-						continue;
-				}
+	if (isOutOfBound(targetPos))
+		return;
 
+	FlowFieldCache::Key key{ getIndex(targetPos), wallVersion, knownWallVersion };
 
-				// get neighbour cells
-				flowFieldCell& currNeighbour = flowField[neighbourPos.row][neighbourPos.col];
+	// still in the layers from the last frame
+	if (key == exitFieldKey)
+		return;
 
+	flowFieldCache.budget = static_cast<size_t>(std::max(flowFieldCacheMb, 0)) << 20;
 
-				// Calculate new distance
-				float newDistance = currCell.distance + distOfTwoCells(targetPos, neighbourPos);
+	if (FlowFieldCache::Field const *field = flowFieldCache.find(key))
+	{
+		resetHeatMap();
+		distance = field->distance;
 
-				// If neighbor is visited and the new distance is shorter, update it
-				if (currNeighbour.visited)
-				{
-					if (newDistance < currNeighbour.distance)
-						currNeighbour.distance = newDistance;
-				}
-				else
-				{
-					// If neighbor is not visited, set the distance and mark as visited
-					currNeighbour.distance = newDistance;
-					currNeighbour.visited = true;
-					openList.push(&currNeighbour);
-				}
-			}
+		// solved for a group, which only keeps the distance
+		if (field->final.empty())
+		{
+			CombineMaps();
+			flowFieldCache.insert(key, distance, final);
 		}
+		else
+			final = field->final;
+	}
+	else
+	{
+		updateHeatMap(target);
+		CombineMaps();
+		flowFieldCache.insert(key, distance, final);
 	}
+
+	exitFieldKey = key;
 }
 
-void Grid::updateHeatMap()
+const FlowFieldCache &Grid::getFlowFieldCache() const
 {
-	// reset the map first
-	resetHeatMap();
+	return flowFieldCache;
+}
+
+void Grid::setGroupGoal(int group, Vec2 target)
+{
+	GridPos goal = getGridPos(target);
+	groupFlowFields.setGoal(group, isOutOfBound(goal) ? -1 : getIndex(goal));
+}
 
-	// push unexplored node into openlist
-	for (auto& row : flowField)
+void Grid::updateGroupFlowFields()
+{
+	// every group goes around the known walls like the exit field does
+	if (groupWallVersion != wallVersion || groupKnownWallVersion != knownWallVersion)
 	{
-		for (auto& flowFieldCell : row)
-		{
-			if (cells[flowFieldCell.position.row][flowFieldCell.position.col].visibility == UNEXPLORED)
-			{
-				flowFieldCell.distance = 0.f;
-				flowFieldCell.visited = true;
-				openList.push(&flowFieldCell);
-			}
-		}
+		updateStepLayers();
+		groupFlowFields.setLayers(height, width, knownCanEnter, blocksCorner);
+		groupWallVersion = wallVersion;
+		groupKnownWallVersion = knownWallVersion;
 	}
 
-	float maxDist{};
-
-	while (!openList.empty())
-	{
-		flowFieldCell& currCell = *openList.front();
+	flowFieldCache.budget = static_cast<size_t>(std::max(flowFieldCacheMb, 0)) << 20;
+	groupFlowFields.update(jobs, flowFieldCache, wallVersion, knownWallVersion);
+}
 
-		openList.pop();
+std::list<Vec2> Grid::findPath(Vec2 start, Vec2 goal, PathMethod method)
+{
+	GridPos from = getGridPos(start), to = getGridPos(goal);
+	std::list<Vec2> waypoints;
 
-		// check its 8 neighour
-		for (int i{ -1 }; i <= 1; ++i)
-		{
-			for (int j{ -1 }; j <= 1; ++j)
-			{
-				// skip self cell
-				if (i == 0 && j == 0)
-					continue;
+	if (isOutOfBound(from) || isOutOfBound(to))
+		return waypoints;
 
-				// create neighour position
-				GridPos neighbourPos{ currCell.position.row + i, currCell.position.col + j };
+	if (method == PathMethod::JPS_PLUS)
+		updateJumpTable();
 
-				// skip out of bound and wall cells
-				if (isOutOfBound(neighbourPos) || isWall(neighbourPos) )
-					continue;
+	if (!pathFinder.findPath(height, width, walls, getIndex(from), getIndex(to), method, pathCells))
+		return waypoints;
 
-				// skip diagonal neighbors if there's an adjacent wall
-				if (i != 0 && j != 0)
-				{
-					GridPos adjacent1{ currCell.position.row + i, currCell.position.col };
-					GridPos adjacent2{ currCell.position.row, currCell.position.col + j };
-					if (isOutOfBound(adjacent1) || isOutOfBound(adjacent2) || isWall(adjacent1) && cells[adjacent1.row][adjacent1.col].visibility != UNEXPLORED || isWall(adjacent2) && cells[adjacent2.row][adjacent2.col].visibility)
-						continue;
-				}
+	// the agent is in the first cell already
+	for (size_t i{ 1 }; i < pathCells.size(); ++i)
+		waypoints.push_back(getWorldPos(pathCells[i] / width, pathCells[i] % width));
 
+	return waypoints;
+}
 
-				// get neighbour cells
-				flowFieldCell& currNeighbour = flowField[neighbourPos.row][neighbourPos.col];
+void Grid::updateJumpTable()
+{
+	if (jumpTableVersion == wallVersion)
+		return;
 
+	pathFinder.buildJumpTable(height, width, walls);
+	jumpTableVersion = wallVersion;
+}
 
-				// Calculate new distance
-				float newDistance = currCell.distance + distOfTwoCells(currCell.position, neighbourPos);
+bool Grid::isHeatMapEdge(int from, int i, int j) const
+{
+	int row = from / width + i;
+	int col = from % width + j;
 
-				maxDist = std::max(maxDist, newDistance);
+	// skip out of bound and wall cells
+	if (isOutOfBound(row, col) || walls[getIndex(row, col)])
+		return false;
 
-				// If neighbor is visited and the new distance is shorter, update it
-				if (currNeighbour.visited)
-				{
-					if (newDistance < currNeighbour.distance)
-						currNeighbour.distance = newDistance;
-				}
-				else
-				{
-					// If neighbor is not visited, set the distance and mark as visited
-					currNeighbour.distance = newDistance;
-					currNeighbour.visited = true;
-					openList.push(&currNeighbour);
-				}
-			}
-		}
+	// skip diagonal neighbors if there's an adjacent wall
+	if (i != 0 && j != 0)
+	{
+		int adjacent1 = getIndex(row, col - j);
+		int adjacent2 = getIndex(row - i, col);
+		if ((walls[adjacent1] && visibility[adjacent1] != UNEXPLORED) || (walls[adjacent2] && visibility[adjacent2] != UNEXPLORED))
+			return false;
 	}
 
-	for (int row{}; row < height; ++row)
-		for (int col{}; col < width; ++col)
-			if(maxDist > 0)
-			flowField[row][col].distance /= maxDist;
+	return true;
+}
 
+void Grid::updateStepLayers()
+{
+	if (!rebuildStepLayers)
+		return;
+
+	rebuildStepLayers = false;
+	canEnter.resize(walls.size());
+	knownCanEnter.resize(walls.size());
+	blocksCorner.resize(walls.size());
+
+	for (int index{}; index < static_cast<int>(walls.size()); ++index)
+		patchStepLayers(index);
 }
 
-void Grid::updatePotentialMap()
+void Grid::patchStepLayers(int index)
 {
-	// clear potential
-	for (auto& row : flowField)
+	// picked up by the rebuild
+	if (rebuildStepLayers)
+		return;
+
+	// known walls block diagonal steps, unexplored ones might still be open
+	blocksCorner[index] = walls[index] && visibility[index] != UNEXPLORED;
+	canEnter[index] = !walls[index];
+	knownCanEnter[index] = !blocksCorner[index];
+}
+
+void Grid::rebuildHeat()
+{
+	updateStepLayers();
+	heat.assign(height * width, std::numeric_limits<float>::max());
+	heatParent.assign(height * width, -1);
+
+	// unexplored cells are the sources
+	for (int index{}; index < height * width; ++index)
+		if (visibility[index] == UNEXPLORED)
+			heat[index] = 0.f;
+
+	if (parallelHeatMap)
 	{
-		for (auto& flowField : row)
-		{
-			flowField.potential = 0.f;
-		}
+		// the tiled solver picks the sources up from the heat layer itself
+		tiledSolver.solve(height, width, canEnter, blocksCorner, heat, &heatParent, jobs);
+		return;
 	}
 
-	float maxPotential{};
+	for (int index{}; index < height * width; ++index)
+		if (heat[index] == 0.f)
+			heatQueue.push(0.f, index);
 
-	// Iterate through the grid in blocks of 4x4
-	for (int i = 0; i < cells.size(); i += pConfig.blockSize)
-	{
-		for (int j = 0; j < cells[0].size(); j += pConfig.blockSize)
+	propagateHeat();
+}
+
+void Grid::repairHeat()
+{
+	auto invalidate = [this](int index)
 		{
-			// Determine if the block is unknown
-			int unknownCount = 0;
-			for (int bi = 0; bi < pConfig.blockSize; ++bi)
-			{
-				for (int bj = 0; bj < pConfig.blockSize; ++bj)
-				{
-					int ni = i + bi;
-					int nj = j + bj;
-					if (!isOutOfBound(GridPos{ ni, nj }) && cells[ni][nj].visibility == UNEXPLORED)
-					{
-						++unknownCount;
-					}
-				}
-			}
+			if (visited[index])
+				return;
+			visited[index] = true;
+			heatInvalid.push_back(index);
+		};
+
+	for (int index : heatChanges)
+	{
+		int row = index / width, col = index % width;
 
-			if (unknownCount >= (int)(pConfig.minUnknownPercent) * (int)std::powf((float)pConfig.blockSize, 2.f))
+		// the changed cell may have lost its source status or become a wall
+		invalidate(index);
+
+		// diagonal steps that squeeze past the changed cell may have been blocked
+		for (int i : { -1, 1 })
+			for (int j : { -1, 1 })
 			{
-				// Calculate the center of the block
-				GridPos blockCenter{ i + pConfig.blockSize / 2, j + pConfig.blockSize / 2 };
-				for (auto& row : flowField)
-				{
-					for (auto& flowFieldCell : row)
-					{
-						// Calculate Manhattan Distance
-						int md = std::abs(flowFieldCell.position.row - blockCenter.row) + std::abs(flowFieldCell.position.col - blockCenter.col);
-						if (md <= pConfig.maxMd)
-						{
-							// Calculate potential
-							float newPotential = pConfig.maxPotential - ((float(md) * pConfig.maxPotential) / pConfig.maxMd);
-							
-							if (newPotential > 0)
-							{
-								flowFieldCell.potential += newPotential;
-								maxPotential = std::max(maxPotential, flowFieldCell.potential);
-							}
-						}
-					}
-				}
+				if (isOutOfBound(row + i, col) || isOutOfBound(row, col + j))
+					continue;
+
+				int vertical = getIndex(row + i, col);
+				int horizontal = getIndex(row, col + j);
+
+				if (heatParent[vertical] == horizontal)
+					invalidate(vertical);
+				if (heatParent[horizontal] == vertical)
+					invalidate(horizontal);
 			}
-		}
 	}
 
-	for (int row{}; row < height; ++row)
-		for (int col{}; col < width; ++col)
-			if(maxPotential > 0)
-			flowField[row][col].potential /= maxPotential;
-}
+	// everything downstream of an invalidated cell has to be recomputed as well
+	for (size_t k{}; k < heatInvalid.size(); ++k)
+	{
+		int row = heatInvalid[k] / width, col = heatInvalid[k] % width;
 
-void Grid::updateRepulsionMap(GridPos gridPos, float radius, float strength)
-{
-	int startRow = std::max(0, gridPos.row - static_cast<int>(radius / cellSize));
-	int endRow = std::min(height - 1, gridPos.row + static_cast<int>(radius / cellSize));
+		for (int i{ -1 }; i <= 1; ++i)
+			for (int j{ -1 }; j <= 1; ++j)
+				if (!isOutOfBound(row + i, col + j) && heatParent[getIndex(row + i, col + j)] == heatInvalid[k])
+					invalidate(getIndex(row + i, col + j));
+	}
 
-	int startCol = std::max(0, gridPos.col - static_cast<int>(radius / cellSize));
-	int endCol = std::min(width - 1, gridPos.col + static_cast<int>(radius / cellSize));
+	for (int index : heatInvalid)
+	{
+		heat[index] = std::numeric_limits<float>::max();
+		heatParent[index] = -1;
+	}
 
-	for (int r = startRow; r <= endRow; ++r)
+	// pull the invalidated cells back from their still valid neighbours
+	for (int index : heatInvalid)
 	{
-		for (int c = startCol; c <= endCol; ++c)
-		{
-			//if (isWall(r, c))
-			//	continue;
+		visited[index] = false;
 
-			// get distance of pos to cell (startRow, startCol)
+		if (visibility[index] == UNEXPLORED)
+		{
+			heat[index] = 0.f;
+			heatQueue.push(0.f, index);
+			continue;
+		}
 
-			Vec2 rowCol = getWorldPos(r, c);
+		GridPos pos{ index / width, index % width };
 
+		for (int i{ -1 }; i <= 1; ++i)
+			for (int j{ -1 }; j <= 1; ++j)
+			{
+				if ((i == 0 && j == 0) || isOutOfBound(pos.row + i, pos.col + j))
+					continue;
 
-			float distance = getWorldPos(gridPos).Distance(rowCol);
+				int neighbourIndex = getIndex(pos.row + i, pos.col + j);
 
-			if (distance <= radius)
-			{
-				if (!isClearPath(gridPos, GridPos{ r, c }))
+				if (heat[neighbourIndex] == std::numeric_limits<float>::max() || !isHeatMapEdge(neighbourIndex, -i, -j))
 					continue;
 
-				flowField[r][c].repulsion += strength * (1.0f - (distance / radius));
+				float newDistance = heat[neighbourIndex] + stepCost(i, j);
+
+				if (newDistance < heat[index])
+				{
+					heat[index] = newDistance;
+					heatParent[index] = neighbourIndex;
+				}
 			}
-		}
+
+		if (heat[index] < std::numeric_limits<float>::max())
+			heatQueue.push(heat[index], index);
 	}
+
+	// steps that were opened up by the change start from the cells around it
+	for (int index : heatChanges)
+	{
+		int row = index / width, col = index % width;
+
+		for (int i{ -1 }; i <= 1; ++i)
+			for (int j{ -1 }; j <= 1; ++j)
+				if (!isOutOfBound(row + i, col + j) && heat[getIndex(row + i, col + j)] < std::numeric_limits<float>::max())
+					heatQueue.push(heat[getIndex(row + i, col + j)], getIndex(row + i, col + j));
+	}
+
+	heatInvalid.clear();
+
+	propagateHeat();
 }
 
-void Grid::updateRepulsionMap(float radius, float strength)
+void Grid::propagateHeat()
 {
-	for (auto& row : flowField)
-	{
-		for (auto& flowFieldCell : row)
-		{
-			if (isWall(flowFieldCell.position.row, flowFieldCell.position.col))
-			{
-				int startRow = std::max(0, flowFieldCell.position.row - static_cast<int>(radius / cellSize));
-				int endRow = std::min(height - 1, flowFieldCell.position.row + static_cast<int>(radius / cellSize));
+	solveField(height, width, canEnter, blocksCorner, heat, &heatParent, heatQueue);
+}
 
-				int startCol = std::max(0, flowFieldCell.position.col - static_cast<int>(radius / cellSize));
-				int endCol = std::min(width - 1, flowFieldCell.position.col + static_cast<int>(radius / cellSize));
+void Grid::markUnexplored(int index)
+{
+	heatChanges.push_back(index);
 
-				for (int r = startRow; r <= endRow; ++r)
-				{
-					for (int c = startCol; c <= endCol; ++c)
-					{
-						// get distance of pos to cell (startRow, startCol)
-						Vec2 rowCol = getWorldPos(r, c);
+	// the exit field goes around known walls only
+	if (walls[index])
+		++knownWallVersion;
 
+	satDirtyRow = std::min(satDirtyRow, index / width);
+	satDirtyCol = std::min(satDirtyCol, index % width);
+}
 
-						float distance = getWorldPos(flowFieldCell.position).Distance(rowCol);
+void Grid::markAllUnexplored()
+{
+	++knownWallVersion;
+	unexploredSat.assign((height + 1) * (width + 1), 0);
+	satDirtyRow = satDirtyCol = 0;
+}
 
-						if (distance <= radius)
-						{
-							flowField[r][c].repulsion += strength * (1.0f - (distance / radius));
+void Grid::updateUnexploredSat() const
+{
+	if (satDirtyRow >= height || satDirtyCol >= width)
+		return;
 
-							// cap repulsion so that multiple walls will not exceed a limit
-							if (flowField[r][c].repulsion > 0.3f)
-								flowField[r][c].repulsion = 0.3f;
-						}
-					}
-				}
-			}
-		}
-	}
+	int stride = width + 1;
+
+	// entries above or left of the first flip still hold
+	for (int row{ satDirtyRow }; row < height; ++row)
+		for (int col{ satDirtyCol }; col < width; ++col)
+			unexploredSat[(row + 1) * stride + col + 1] = (visibility[getIndex(row, col)] == UNEXPLORED)
+				+ unexploredSat[row * stride + col + 1] + unexploredSat[(row + 1) * stride + col] - unexploredSat[row * stride + col];
 
+	satDirtyRow = height;
+	satDirtyCol = width;
 }
 
-void Grid::normalizeRepulsionMap()
+void Grid::updatePotentialMap()
 {
-	float maxRepulsion{};
+	potentialCentres.clear();
 
-	for (auto& row : flowField)
+	// Iterate through the grid in blocks of 4x4
+	for (int i = 0; i < height; i += pConfig.blockSize)
 	{
-		for (auto& flowFieldCell : row)
+		for (int j = 0; j < width; j += pConfig.blockSize)
 		{
-			maxRepulsion = std::max(maxRepulsion, flowFieldCell.repulsion);
-		}
-	}
+			// Determine if the block is unknown
+			int unknownCount = countUnexplored(i, j, i + pConfig.blockSize, j + pConfig.blockSize);
 
-	for (auto& row : flowField)
-	{
-		for (auto& flowFieldCell : row)
-		{
-			if (maxRepulsion > 0)
-				flowFieldCell.repulsion /= maxRepulsion;
+			// the center of the block radiates potential
+			if (unknownCount >= pConfig.minUnknownPercent * pConfig.blockSize * pConfig.blockSize)
+				potentialCentres.push_back({ i + pConfig.blockSize / 2, j + pConfig.blockSize / 2 });
 		}
 	}
 
+	// potential falls off linearly with the Manhattan distance to every center, up to maxMd
+	potentialFilter.apply(height, width, potentialCentres, pConfig.maxMd, pConfig.maxPotential / pConfig.maxMd, potential);
 
+	kernel::normalizeMax(potential.data(), potential.size());
+	hasPotential = true;
 }
 
-void Grid::CombineMaps()
+void Grid::clearPotentialMap()
 {
-	for (auto& row : flowField)
-	{
-		for (auto& cell : row)
-		{
-			if (isWall(cell.position))
-			{
-				continue;
-			}
+	if (!hasPotential)
+		return;
 
-			cell.final = cell.distance + cell.repulsion - cell.potential * pConfig.potentialWeight;		
-		}
-	}
+	std::fill(potential.begin(), potential.end(), 0.f);
+	hasPotential = false;
+}
+
+void Grid::updateRepulsionMap(GridPos gridPos, float radius, float strength)
+{
+	if (isOutOfBound(gridPos.row, gridPos.col) || !(radius > 0.f))
+		return;
 
-	// Step 2: Find the minimum and maximum final values
-	float minFinal = std::numeric_limits<float>::max();
-	float maxFinal = std::numeric_limits<float>::min();
+	// cells within the radius the position can see, cached until the walls change
+	LosCache::Mask const &mask = losCache.get(height, width, walls.data(), wallVersion, gridPos.row, gridPos.col, radius / cellSize);
 
-	for (auto& row : flowField)
-	{
-		for (auto& cell : row)
+	mask.forEach([&](int row, int col)
 		{
-			if (isWall(cell.position))
-			{
-				continue;
-			}
+			float dr = static_cast<float>(row - gridPos.row);
+			float dc = static_cast<float>(col - gridPos.col);
+			float distance = std::sqrt(dr * dr + dc * dc) * cellSize;
 
-			if (cell.final < minFinal)
-			{
-				minFinal = cell.final;
-			}
-			if (cell.final > maxFinal)
-			{
-				maxFinal = cell.final;
-			}
-		}
+			repulsion[getIndex(row, col)] += strength * (1.0f - (distance / radius));
+		});
+
+	hasRepulsion = true;
+}
+
+void Grid::updateRepulsionMap(float radius, float strength)
+{
+	// the distance transform only changes with the walls
+	if (wallDistanceVersion != wallVersion)
+	{
+		squaredDistanceTransform(height, width, walls, wallDistance);
+		wallDistanceVersion = wallVersion;
 	}
 
-	// Step 3: Normalize the final values to range 0-1
-	for (auto& row : flowField)
+	hasRepulsion = true;
+
+	// overwrites the layer, so the per-enemy repulsion has to be added after this
+	for (size_t index{}; index < repulsion.size(); ++index)
 	{
-		for (auto& cell : row)
-		{
-			if (maxFinal > minFinal) // To avoid division by zero
-			{
-				cell.final = (cell.final - minFinal) / (maxFinal - minFinal);
-			}
-			else
-			{
-				cell.final = 0.0f; // If all values are the same, set them to 0
-			}
-		}
+		float distance = std::sqrt(wallDistance[index]) * cellSize;
+
+		// cap repulsion so that walls will not exceed a limit
+		repulsion[index] = distance <= radius ? std::min(strength * (1.0f - (distance / radius)), 0.3f) : 0.f;
 	}
 }
 
+void Grid::clearRepulsionMap()
+{
+	if (!hasRepulsion)
+		return;
+
+	std::fill(repulsion.begin(), repulsion.end(), 0.f);
+	hasRepulsion = false;
+}
+
+void Grid::normalizeRepulsionMap()
+{
+	kernel::normalizeMax(repulsion.data(), repulsion.size());
+}
+
+void Grid::CombineMaps()
+{
+	// combine, find the range of the non-wall cells and normalize the final values to 0-1
+	kernel::combine(distance.data(), repulsion.data(), potential.data(), walls.data(), pConfig.potentialWeight, final.data(), final.size());
+	++finalGeneration;
+	exitFieldKey = {};
+}
+
 void Grid::resetHeatMap()
 {
-	for (int row{}; row < height; ++row)
-	{
-		for (int col{}; col < width; ++col)
-		{
-			flowField[row][col].distance = std::numeric_limits<float>::max();
-			flowField[row][col].potential = 0.f;
-			flowField[row][col].repulsion = 0.f;
-			flowField[row][col].final = 0.f;
-			flowField[row][col].visited = false;
-			flowField[row][col].direction = { 0, 0 };
-		}
-	}
+	std::fill(distance.begin(), distance.end(), std::numeric_limits<float>::max());
+	std::fill(potential.begin(), potential.end(), 0.f);
+	std::fill(repulsion.begin(), repulsion.end(), 0.f);
+	std::fill(final.begin(), final.end(), 0.f);
+	std::fill(visited.begin(), visited.end(), false);
+	std::fill(direction.begin(), direction.end(), Vec2{ 0, 0 });
+	hasPotential = hasRepulsion = false;
+	++finalGeneration;
+	exitFieldKey = {};
 }
 
 
 void Grid::generateFlowField()
 {
 	for (int row{}; row < height; ++row)
-	{
 		for (int col{}; col < width; ++col)
+			getFlowFieldDir(row, col);
+}
+
+Vec2 Grid::computeFlowFieldDir(int row, int col) const
+{
+	// get current cells
+	int index = getIndex(row, col);
+	Vec2 currDir{};
+
+	if (utl::isEqual(final[index], 0.f))
+		return direction[index];
+
+	// Skip walls
+	if (walls[index] && visibility[index] != UNEXPLORED)
+		return direction[index];
+
+	if (visibility[index] == UNEXPLORED)
+		return direction[index];
+	
+	// if goal node is found, we double break
+	bool goalBreak{ false };
+	
+	// ===============================================
+	// To check if there is wall amongst its neighbour
+	// ===============================================
+	bool minimumMode{ false }; // this mode is enabled if there is a wall among its neighbour
+	float minDist{ std::numeric_limits<float>::max() };	// to store the min distancce for the case of minimumMode
+	GridPos minDir{};
+
+	// check its neighbour to generate direction vector
+	for (int i{ -1 }; i <= 1; ++i)
+	{
+		for (int j{ -1 }; j <= 1; ++j)
 		{
-			// get current cells
-			flowFieldCell &currCell = flowField[row][col];
+			int neighbourRow = row + i;
+			int neighbourCol = col + j;
 
-			if (utl::isEqual(currCell.final, 0.f))
+			// skip self cell
+			if ( i == 0 && j == 0)
 				continue;
 
-			// Skip walls
-			if (isWall(row, col) && cells[row][col].visibility != UNEXPLORED)
+			if (isOutOfBound(neighbourRow, neighbourCol))
+			{
+				minimumMode = true;
 				continue;
+			}
 
-			if (cells[row][col].visibility == UNEXPLORED)
-				continue;
-			
-			// if goal node is found, we double break
-			bool goalBreak{ false };
-			
-			// ===============================================
-			// To check if there is wall amongst its neighbour
-			// ===============================================
-			bool minimumMode{ false }; // this mode is enabled if there is a wall among its neighbour
-			float minDist{ std::numeric_limits<float>::max() };	// to store the min distancce for the case of minimumMode
-			GridPos minDir{};
-
-			// check its neighbour to generate direction vector
-			for (int i{ -1 }; i <= 1; ++i)
-			{
-				for (int j{ -1 }; j <= 1; ++j)
-				{
-					int neighbourRow = row + i;
-					int neighbourCol = col + j;
+			// get current neighbour
+			int neighbourIndex = getIndex(neighbourRow, neighbourCol);
 
-					// skip self cell
-					if ( i == 0 && j == 0)
-						continue;
 
-					if (isOutOfBound(neighbourRow, neighbourCol))
-					{
-						minimumMode = true;
-						continue;
-					}
-
-					// get current neighbour
-					flowFieldCell& neighbourCell = flowField[neighbourRow][neighbourCol];
-
-
-					// skip diagonal neighbors if there's an adjacent wall
-					if (i != 0 && j != 0)
-					{
-						if (isOutOfBound(row + i, col) || isOutOfBound(row, col + j) || isWall(row + i, col) && cells[row + i][col].visibility != UNEXPLORED || isWall(row, col + j) && cells[row][col + j].visibility != UNEXPLORED)
-						{
-							minimumMode = true;
-							continue;
-						}
-					}
-
-					// if there is walls amongst neighbour
-					if (isWall(neighbourRow, neighbourCol) && cells[neighbourRow][neighbourCol].visibility != UNEXPLORED || isOutOfBound(neighbourRow, neighbourCol)) // if there is a wall amongst its neighbour
-					{
-						minimumMode = true;
-						continue;
-					}
-					
-					// if pointing directly to goal node
-					if (utl::isEqual(neighbourCell.final, 0.f))
-					{
-						currCell.direction = Vec2((float)j, (float)i);
-						goalBreak = true;
-						minimumMode = false;
-						break;
-					}
-						
-					// for MINNIMUM MODE
-					if (neighbourCell.final < minDist)
-					{
-						minDist = neighbourCell.final;
-						minDir = { i, j };
-
-					}
-
-					// GRADIENT MODE
-					// get final directional vector
-					currCell.direction += (1.f / neighbourCell.final) * Vec2((float)j, (float)i);
+			// skip diagonal neighbors if there's an adjacent wall
+			if (i != 0 && j != 0)
+			{
+				int adjacent1 = getIndex(row + i, col);
+				int adjacent2 = getIndex(row, col + j);
+				if ((walls[adjacent1] && visibility[adjacent1] != UNEXPLORED) || (walls[adjacent2] && visibility[adjacent2] != UNEXPLORED))
+				{
+					minimumMode = true;
+					continue;
 				}
-
-				if (goalBreak)
-					break;
 			}
 
-			if (minimumMode)
-				currCell.direction = Vec2((float)minDir.col, (float)minDir.row);
+			// if there is walls amongst neighbour
+			if (walls[neighbourIndex] && visibility[neighbourIndex] != UNEXPLORED) // if there is a wall amongst its neighbour
+			{
+				minimumMode = true;
+				continue;
+			}
 			
+			// if pointing directly to goal node
+			if (utl::isEqual(final[neighbourIndex], 0.f))
+			{
+				currDir = Vec2((float)j, (float)i);
+				goalBreak = true;
+				minimumMode = false;
+				break;
+			}
+				
+			// for MINNIMUM MODE
+			if (final[neighbourIndex] < minDist)
+			{
+				minDist = final[neighbourIndex];
+				minDir = { i, j };
+
+			}
+
+			// GRADIENT MODE
+			// get final directional vector
+			currDir += (1.f / final[neighbourIndex]) * Vec2((float)j, (float)i);
 		}
+
+		if (goalBreak)
+			break;
 	}
+
+	if (minimumMode)
+		currDir = Vec2((float)minDir.col, (float)minDir.row);
+
+	return currDir;
+}
+
+void Grid::setFlowFieldGoal(Vec2 target)
+{
+	GridPos goal = getGridPos(target);
+	sectorFlowField.setGoal(goal.row, goal.col);
+}
+
+bool Grid::isSectorFlowField() const
+{
+	return hierarchicalFlowField && exitFound;
+}
+
+void Grid::resetSectorFlowField()
+{
+	std::vector<unsigned char> knownWalls(walls.size());
+
+	for (size_t index{}; index < walls.size(); ++index)
+		knownWalls[index] = walls[index] && visibility[index] != UNEXPLORED;
+
+	sectorFlowField.reset(height, width, std::move(knownWalls));
 }
 
 void Grid::changeMap(const std::string& mapName)
 {
 	resetMap();
 
-	const std::vector<std::vector<bool>>& indexCells = loader.getMap(mapName);
-	size_t newWidth = indexCells.size() ? indexCells[0].size() : 0;
-	for (const std::vector<bool>& row : indexCells)
-		crashIf(newWidth != row.size(), "Map " + utl::quote(mapName) + " has rows of different sizes");
-
-	height = (int)indexCells.size();
-	width = (int)newWidth;
-	cells = std::vector<std::vector<Cell>>();
-	flowField = std::vector<std::vector<flowFieldCell>>();
+	const MapData &map = loader.getMap(mapName);
+	crashIf(map.walls.size() != static_cast<size_t>(map.rows) * map.cols, "Map " + utl::quote(mapName) + " has rows of different sizes");
+
+	height = map.rows;
+	width = map.cols;
+	walls = map.walls;
+	visibility.assign(walls.size(), UNEXPLORED);
+	distance.assign(walls.size(), std::numeric_limits<float>::max());
+	potential.assign(walls.size(), 0.f);
+	repulsion.assign(walls.size(), 0.f);
+	final.assign(walls.size(), 0.f);
+	direction.assign(walls.size(), Vec2{ 0, 0 });
+	directionGeneration.assign(walls.size(), 0);
+	visited.assign(walls.size(), false);
+	cells.assign(walls.size(), Cell{});
 
-	for (unsigned i = 0; i < (unsigned)height; ++i)
-	{
-		cells.push_back(std::vector<Cell>());
-		flowField.push_back(std::vector<flowFieldCell>());
-		
-		for (unsigned j = 0; j < (unsigned)width; ++j)
-		{
-			flowField.back().emplace_back();
-			flowField.back().back().position = { (int)i, (int)j };
-			cells.back().emplace_back(Vec2{ cellSize, cellSize });
-			cells.back().back().isWall = indexCells[i][j];
-			cells.back().back().pos = { (int)i, (int)j };
-
-			sf::RectangleShape &currCell = cells.back().back().rect;
-			currCell.setOrigin(cellSize / 2.f, cellSize / 2.f);
-			currCell.setPosition(j * cellSize, i * cellSize);
-			currCell.setFillColor(indexCells[i][j] ? colors.at("Wall").first : colors.at("Floor").first); 
-			currCell.setOutlineColor(indexCells[i][j] ? colors.at("Wall").second : colors.at("Floor").second);
-			currCell.setOutlineThickness(1.f);
-		}
-	}
+	for (int i = 0; i < height; ++i)
+		for (int j = 0; j < width; ++j)
+			initCell(i, j, 1.f);
+
+	rebuildHeatMap = true;
+	rebuildStepLayers = true;
+	++wallVersion;
+	markAllUnexplored();
+	changes.isResized = changes.isMapReplaced = true;
+
+	// read with the map if it was cached next to it, otherwise built on the first search that needs it
+	pathFinder.setJumpTable(height, width, map.jumps);
+	if (pathFinder.hasJumpTable(height, width))
+		jumpTableVersion = wallVersion;
 }
 
 void Grid::clearMap()
 {
-	for (std::vector<Cell> &row : cells)
-		for (Cell &cell : row)
-		{
-			cell.isWall = false;
-			cell.rect.setFillColor(colors.at("Floor").first);
-			cell.rect.setFillColor(colors.at("Floor").second);
-		}
+	std::fill(walls.begin(), walls.end(), false);
+	rebuildHeatMap = true;
+	rebuildStepLayers = true;
+	++wallVersion;
+	changes.isMapReplaced = true;
+
+	for (Cell &cell : cells)
+	{
+		cell.rect.setFillColor(colors.at("Floor").first);
+		cell.rect.setFillColor(colors.at("Floor").second);
+	}
 }
 
 void Grid::resetMap()
@@ -1029,10 +1089,13 @@ void Grid::resetMap()
 	for (Enemy *enemy : factory.getEntities<Enemy>())
 		factory.destroyEntity<Enemy>(enemy);
 
+	groupFlowFields.clear();
+
 	if (exitCell)
 	{
 		exitCell->isExit = false;
 		exitCell = nullptr;
+		changes.isExitMoved = true;
 	}
 
 	exitFound = false;
@@ -1042,9 +1105,12 @@ void Grid::resetMap()
 
 void Grid::resetFog()
 {
-	for (std::vector<Cell> &row : cells)
-		for (Cell &cell : row)
-			cell.visibility = UNEXPLORED;
+	std::fill(visibility.begin(), visibility.end(), UNEXPLORED);
+	rebuildHeatMap = true;
+	rebuildStepLayers = true;
+	markAllUnexplored();
+	collectVisibleCells();
+	changes.isMapReplaced = true;
 }
 
 // potential field
@@ -1059,15 +1125,15 @@ void Grid::generateRandomGoal()
 	srand((unsigned)time(0));
 	int exitX = rand() % width;
 	int exitY = rand() % height;
-	cells[exitY][exitX].isExit = true;
-
-	exitCell = &cells[exitY][exitX];
+	exitCell = &cells[getIndex(exitY, exitX)];
+	exitCell->isExit = true;
+	changes.isExitMoved = true;
 }
 
 void Grid::generateMap()
 {
 	// so it doesn't crash on empty map
-	if (cells.empty() || cells[0].empty())
+	if (cells.empty())
 		return;
 
 	// so it doesn't crash if min > max
@@ -1076,32 +1142,36 @@ void Grid::generateMap()
 
 	// initialise map
 	resetMap();
-	for (std::vector<Cell> &row : cells)
-		for (Cell &cell : row)
-		{
-			cell.isVisited = false;
-			cell.connections = 0;
-			cell.parents.clear();
-			cell.parents.push_back(nullptr);
-			cell.isWall = true;
-
-			// didn't do anything
-			//if (config.deviation)
-			//{
-			//	float fx = utl::randInt(config.minConnections - 1, config.maxConnections - 1);
-			//	float ex = getEx(cell.pos);
-
-			//	cell.connections = utl::clamp(ex + (fx - ex) * (config.deviation / 10.f),
-			//		config.minConnections - 1.f, config.maxConnections - 1.f);
-			//	cell.visitsLeft = utl::round(cell.connections);
-			//	//PRINT(cell.connections, cell.visitsLeft);
-			//}
-			//else
-			cell.visitsLeft = utl::randInt(config.minConnections - 1, config.maxConnections - 1);
-		}
+	std::fill(walls.begin(), walls.end(), true);
+	rebuildHeatMap = true;
+	rebuildStepLayers = true;
+	++wallVersion;
+	changes.isMapReplaced = true;
+
+	for (Cell &cell : cells)
+	{
+		cell.isVisited = false;
+		cell.connections = 0;
+		cell.parents.clear();
+		cell.parents.push_back(nullptr);
+
+		// didn't do anything
+		//if (config.deviation)
+		//{
+		//	float fx = utl::randInt(config.minConnections - 1, config.maxConnections - 1);
+		//	float ex = getEx(cell.pos);
+
+		//	cell.connections = utl::clamp(ex + (fx - ex) * (config.deviation / 10.f),
+		//		config.minConnections - 1.f, config.maxConnections - 1.f);
+		//	cell.visitsLeft = utl::round(cell.connections);
+		//	//PRINT(cell.connections, cell.visitsLeft);
+		//}
+		//else
+		cell.visitsLeft = utl::randInt(config.minConnections - 1, config.maxConnections - 1);
+	}
 
 	std::stack<Cell *> openList; // bfs
-	openList.push(&cells[0][0]);
+	openList.push(&cells[0]);
 
 	// generate perfect maze using random walk algorithm
 	while (openList.size())
@@ -1124,116 +1194,113 @@ void Grid::generateMap()
 	}
 
 	// remove walls
-	for (std::vector<Cell> &row : cells)
-		for (Cell &cell : row)
+	for (Cell &cell : cells)
+	{
+		for (Cell *parent : cell.parents)
 		{
-			for (Cell *parent : cell.parents)
+			if (!parent)
+				continue;
+			//waypoints.push_back(&cell);
+
+			if (parent->pos.row == cell.pos.row) // same row
 			{
-				if (!parent)
-					continue;
-				//waypoints.push_back(&cell);
+				int maxCol = std::max(parent->pos.col, cell.pos.col);
+				int minCol = std::min(parent->pos.col, cell.pos.col);
 
-				if (parent->pos.row == cell.pos.row) // same row
+				for (int j = 1; j < config.wallSize + 1; j = std::abs(j) + 1)
 				{
-					int maxCol = std::max(parent->pos.col, cell.pos.col);
-					int minCol = std::min(parent->pos.col, cell.pos.col);
-
-					for (int j = 1; j < config.wallSize + 1; j = std::abs(j) + 1)
-					{
-						j = j % 2 ? -j : j; // remove walls left and right of main path
-
-						// before start cell
-						for (int i = minCol - config.wallSize / 2; i < minCol; ++i)
-							if (!isOutOfBound(cell.pos.row + j / 2, i) &&
-								shouldEraseWall({ cell.pos.row + j / 2, i }, { cell.pos.row + j / 2, i - 1 },
-									i == minCol - config.wallSize / 2))
-								cells[cell.pos.row + j / 2][i].isWall = false;
-
-						// between start and end cell
-						if (!isOutOfBound(cell.pos.row + j / 2, maxCol))
-							for (int i = minCol; i <= maxCol; ++i)
-								if (!(j / 2) || shouldEraseWall({ cell.pos.row + j / 2, i },
-									{ cell.pos.row + j / 2, i - 1 }, false))
-									cells[cell.pos.row + j / 2][i].isWall = false;
-
-						// after end cell
-						for (int i = maxCol + config.wallSize / 2; i > maxCol; --i)
-							if (!isOutOfBound(cell.pos.row + j / 2, i) &&
-								shouldEraseWall({ cell.pos.row + j / 2, i },
-									{ cell.pos.row + j / 2, i - 1 }, i == minCol - config.wallSize / 2))
-								cells[cell.pos.row + j / 2][i].isWall = false;
-					}
+					j = j % 2 ? -j : j; // remove walls left and right of main path
+
+					// before start cell
+					for (int i = minCol - config.wallSize / 2; i < minCol; ++i)
+						if (!isOutOfBound(cell.pos.row + j / 2, i) &&
+							shouldEraseWall({ cell.pos.row + j / 2, i }, { cell.pos.row + j / 2, i - 1 },
+								i == minCol - config.wallSize / 2))
+							walls[getIndex(cell.pos.row + j / 2, i)] = false;
+
+					// between start and end cell
+					if (!isOutOfBound(cell.pos.row + j / 2, maxCol))
+						for (int i = minCol; i <= maxCol; ++i)
+							if (!(j / 2) || shouldEraseWall({ cell.pos.row + j / 2, i },
+								{ cell.pos.row + j / 2, i - 1 }, false))
+								walls[getIndex(cell.pos.row + j / 2, i)] = false;
+
+					// after end cell
+					for (int i = maxCol + config.wallSize / 2; i > maxCol; --i)
+						if (!isOutOfBound(cell.pos.row + j / 2, i) &&
+							shouldEraseWall({ cell.pos.row + j / 2, i },
+								{ cell.pos.row + j / 2, i - 1 }, i == minCol - config.wallSize / 2))
+							walls[getIndex(cell.pos.row + j / 2, i)] = false;
 				}
-				else // same col
+			}
+			else // same col
+			{
+				int maxRow = std::max(parent->pos.row, cell.pos.row);
+				int minRow = std::min(parent->pos.row, cell.pos.row);
+
+				for (int j = 1; j < config.wallSize + 1; j = std::abs(j) + 1)
 				{
-					int maxRow = std::max(parent->pos.row, cell.pos.row);
-					int minRow = std::min(parent->pos.row, cell.pos.row);
-
-					for (int j = 1; j < config.wallSize + 1; j = std::abs(j) + 1)
-					{
-						j = j % 2 ? -j : j; // remove walls left and right of main path
-
-						// before start cell
-						for (int i = minRow - config.wallSize / 2; i < minRow; ++i)
-							if (!isOutOfBound(i, cell.pos.col + j / 2) &&
-								shouldEraseWall({ i, cell.pos.col + j / 2 }, { i - 1, cell.pos.col + j / 2 },
-									i == minRow - config.wallSize / 2))
-								cells[i][cell.pos.col + j / 2].isWall = false;
-
-						// between start and end cell
-						if (!isOutOfBound(maxRow, cell.pos.col + j / 2))
-							for (int i = minRow; i <= maxRow; ++i)
-								if (!(j / 2) || shouldEraseWall({ i, cell.pos.col + j / 2 },
-									{ i - 1, cell.pos.col + j / 2 }, false))
-									cells[i][cell.pos.col + j / 2].isWall = false;
-
-						// after end cell
-						for (int i = maxRow + config.wallSize / 2; i > maxRow; --i)
-							if (!isOutOfBound(i, cell.pos.col + j / 2) &&
-								shouldEraseWall({ i, cell.pos.col + j / 2 },
-									{ i - 1, cell.pos.col + j / 2 }, i == maxRow + config.wallSize / 2))
-								cells[i][cell.pos.col + j / 2].isWall = false;
-					}
+					j = j % 2 ? -j : j; // remove walls left and right of main path
+
+					// before start cell
+					for (int i = minRow - config.wallSize / 2; i < minRow; ++i)
+						if (!isOutOfBound(i, cell.pos.col + j / 2) &&
+							shouldEraseWall({ i, cell.pos.col + j / 2 }, { i - 1, cell.pos.col + j / 2 },
+								i == minRow - config.wallSize / 2))
+							walls[getIndex(i, cell.pos.col + j / 2)] = false;
+
+					// between start and end cell
+					if (!isOutOfBound(maxRow, cell.pos.col + j / 2))
+						for (int i = minRow; i <= maxRow; ++i)
+							if (!(j / 2) || shouldEraseWall({ i, cell.pos.col + j / 2 },
+								{ i - 1, cell.pos.col + j / 2 }, false))
+								walls[getIndex(i, cell.pos.col + j / 2)] = false;
+
+					// after end cell
+					for (int i = maxRow + config.wallSize / 2; i > maxRow; --i)
+						if (!isOutOfBound(i, cell.pos.col + j / 2) &&
+							shouldEraseWall({ i, cell.pos.col + j / 2 },
+								{ i - 1, cell.pos.col + j / 2 }, i == maxRow + config.wallSize / 2))
+							walls[getIndex(i, cell.pos.col + j / 2)] = false;
 				}
 			}
 		}
+	}
 
 		// reinitialise map
-		for (std::vector<Cell> &row : cells)
-			for (Cell &cell : row)
-				cell.isVisited = false;
+		for (Cell &cell : cells)
+			cell.isVisited = false;
 
 		// clear openList
 		while (openList.size())
 			openList.pop();
 
 		// find islands (using bfs) and clear them if they are below the minimum size
-		for (std::vector<Cell> &row : cells)
-			for (Cell &cell : row)
-				if (cell.isWall && !cell.isVisited/* && utl::randInt(0, 99) >= config.openness*/)
+		for (Cell &cell : cells)
+			if (walls[getIndex(cell.pos)] && !cell.isVisited/* && utl::randInt(0, 99) >= config.openness*/)
+			{
+				openList.push(&cell);
+				std::vector<Cell *> island;
+
+				while (openList.size())
 				{
-					openList.push(&cell);
-					std::vector<Cell *> island;
-
-					while (openList.size())
-					{
-						Cell &currCell = *openList.top();
-						openList.pop();
-						if (currCell.isVisited)
-							continue;
-
-						island.push_back(&currCell);
-						currCell.isVisited = true;
-
-						for (Cell *neighbor : getOrthNeighbors(currCell.pos, 1))
-							if (neighbor->isWall)
-								openList.push(neighbor);
-					}
-
-					if (island.size() < config.minIslandSize)
-						for (Cell *wall : island)
-							wall->isWall = false;
+					Cell &currCell = *openList.top();
+					openList.pop();
+					if (currCell.isVisited)
+						continue;
+
+					island.push_back(&currCell);
+					currCell.isVisited = true;
+
+					for (Cell *neighbor : getOrthNeighbors(currCell.pos, 1))
+						if (walls[getIndex(neighbor->pos)])
+							openList.push(neighbor);
 				}
+
+				if (static_cast<int>(island.size()) < config.minIslandSize)
+					for (Cell *wall : island)
+						walls[getIndex(wall->pos)] = false;
+			}
 }
 
 bool Grid::shouldEraseWall(GridPos currCell, GridPos prevCell, bool isFirst)
@@ -1243,8 +1310,8 @@ bool Grid::shouldEraseWall(GridPos currCell, GridPos prevCell, bool isFirst)
 	// 10 noise = 50% chance for wall to spawn behind wall, and vice versa)
 	return utl::randInt(1, 20) - 
 		(config.isEqualWidth ? (isFirst ? 1 : 
-			(isOutOfBound(prevCell) ? 1 : !cells[prevCell.row][prevCell.col].isWall)) :
-			(isOutOfBound(prevCell) ? 1 : !cells[prevCell.row][prevCell.col].isWall)) *
+			(isOutOfBound(prevCell) ? 1 : !walls[getIndex(prevCell)])) :
+			(isOutOfBound(prevCell) ? 1 : !walls[getIndex(prevCell)])) *
 		(20 - config.noise * 2) <= config.noise;
 }
 
@@ -1258,9 +1325,67 @@ void Grid::setExit(GridPos pos)
 
 	if (!isOutOfBound(pos))
 	{
-		exitCell = &cells[pos.row][pos.col];
+		exitCell = &cells[getIndex(pos)];
 		exitCell->isExit = true;
 	}		
+
+	changes.isExitMoved = true;
+}
+
+// =======
+// CHANGES
+// =======
+
+int Grid::subscribe(ChangeListener listener)
+{
+	listeners.push_back({ nextListenerId, std::move(listener) });
+	return nextListenerId++;
+}
+
+void Grid::unsubscribe(int id)
+{
+	listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [id](auto const &listener) { return listener.first == id; }), listeners.end());
+}
+
+void Grid::publishChanges()
+{
+	// the sector flow field only sees known walls, and only through here
+	if (changes.isMapReplaced)
+		resetSectorFlowField();
+	else
+	{
+		for (int index : changes.walls)
+			sectorFlowField.setBlocked(index, walls[index] && visibility[index] != UNEXPLORED);
+		for (int index : changes.visibility)
+			sectorFlowField.setBlocked(index, walls[index] && visibility[index] != UNEXPLORED);
+	}
+
+	for (auto const &[id, listener] : listeners)
+		listener(changes);
+
+	changes.clear();
+}
+
+const GridChanges &Grid::getChanges() const
+{
+	return changes;
+}
+
+void Grid::recordChange(std::vector<int> &list, int index)
+{
+	if (changes.isMapReplaced)
+		return;
+
+	// past one entry per cell a full recompute is cheaper for the listeners anyway
+	if (list.size() >= walls.size())
+	{
+		changes.walls.clear();
+		changes.visibility.clear();
+		changes.isMapReplaced = true;
+		return;
+	}
+
+	list.push_back(index);
 }
 
 // =======
@@ -1320,30 +1445,46 @@ float Grid::distOfTwoCells(GridPos lhs, GridPos rhs) const
 
 Vec2 Grid::getFlowFieldDir(int row, int col) const
 {
-	return flowField[row][col].direction;
+	if (isSectorFlowField())
+		return sectorFlowField.getDirection(row, col);
+
+	int index = getIndex(row, col);
+
+	if (directionGeneration[index] != finalGeneration)
+	{
+		direction[index] = computeFlowFieldDir(row, col);
+		directionGeneration[index] = finalGeneration;
+	}
+
+	return direction[index];
 }
 
 Vec2 Grid::getFlowFieldDir(GridPos pos) const { return getFlowFieldDir(pos.row, pos.col); }
 
+Vec2 Grid::getFlowFieldDir(int group, GridPos pos) const
+{
+	return group < 0 ? getFlowFieldDir(pos) : groupFlowFields.getDirection(group, pos.row, pos.col);
+}
+
 std::vector<Cell *> Grid::getOrthNeighbors(GridPos pos, int steps)
 {
 	std::vector<Cell *> ret;
 
 	// north
 	if (!isOutOfBound(pos.row - steps, pos.col))
-		ret.push_back(&cells[pos.row - steps][pos.col]);
+		ret.push_back(&cells[getIndex(pos.row - steps, pos.col)]);
 	
 	// south
 	if (!isOutOfBound(pos.row + steps, pos.col))
-		ret.push_back(&cells[pos.row + steps][pos.col]);
+		ret.push_back(&cells[getIndex(pos.row + steps, pos.col)]);
 
 	// east
 	if (!isOutOfBound(pos.row, pos.col + steps))
-		ret.push_back(&cells[pos.row][pos.col + steps]);
+		ret.push_back(&cells[getIndex(pos.row, pos.col + steps)]);
 
 	// west
 	if (!isOutOfBound(pos.row, pos.col - steps))
-		ret.push_back(&cells[pos.row][pos.col - steps]);
+		ret.push_back(&cells[getIndex(pos.row, pos.col - steps)]);
 
 	return ret;
 }
@@ -1354,7 +1495,7 @@ std::vector<Vec2> Grid::getNeighborWalls(GridPos pos)
 
 	for (int i = pos.row - 1; i < pos.row + 2; ++i)
 		for (int j = pos.col - 1; j < pos.col + 2; ++j)
-			if (isOutOfBound(i, j) || cells[i][j].isWall)
+			if (isWall(i, j))
 				ret.push_back(getWorldPos(i, j));
 
 	return ret;
@@ -1366,15 +1507,15 @@ float Grid::getEx(GridPos pos)
 
 	// north west
 	ex += isOutOfBound(pos.row - 1, pos.col - 1) ? static_cast<float>(utl::randInt(
-		config.minConnections - 1, config.maxConnections - 1)) : cells[pos.row - 1][pos.col - 1].connections;
+		config.minConnections - 1, config.maxConnections - 1)) : cells[getIndex(pos.row - 1, pos.col - 1)].connections;
 
 	// north
 	ex += isOutOfBound(pos.row - 1, pos.col) ? static_cast<float>(utl::randInt(
-		config.minConnections - 1, config.maxConnections - 1)) : cells[pos.row - 1][pos.col].connections;
+		config.minConnections - 1, config.maxConnections - 1)) : cells[getIndex(pos.row - 1, pos.col)].connections;
 
 	// west
 	ex += isOutOfBound(pos.row, pos.col - 1) ? static_cast<float>(utl::randInt(
-		config.minConnections - 1, config.maxConnections - 1)) : cells[pos.row][pos.col - 1].connections;
+		config.minConnections - 1, config.maxConnections - 1)) : cells[getIndex(pos.row, pos.col - 1)].connections;
 
 	return ex / 3.f;
 }
@@ -1383,20 +1524,46 @@ float Grid::getMaxDist() const
 {
 	float maxDist{};
 
-	for (int row{}; row < height; ++row)
-		for (int col{}; col < width; ++col)
-			maxDist = std::max(maxDist, flowField[row][col].distance);
+	for (float dist : distance)
+		maxDist = std::max(maxDist, dist);
 
 	return maxDist;
 }
 
+int Grid::countUnexplored(int row0, int col0, int row1, int col1) const
+{
+	row0 = std::clamp(row0, 0, height);
+	col0 = std::clamp(col0, 0, width);
+	row1 = std::clamp(row1, row0, height);
+	col1 = std::clamp(col1, col0, width);
+
+	updateUnexploredSat();
+
+	int stride = width + 1;
+	return unexploredSat[row1 * stride + col1] - unexploredSat[row0 * stride + col1]
+		- unexploredSat[row1 * stride + col0] + unexploredSat[row0 * stride + col0];
+}
+
 // =======
 // SETTERS
 // =======
 
 void Grid::setVisibility(int row, int col, Visibility visibility)
 {
-	cells[row][col].visibility = visibility;
+	int index = getIndex(row, col);
+
+	if ((this->visibility[index] == UNEXPLORED) != (visibility == UNEXPLORED))
+		markUnexplored(index);
+
+	if (this->visibility[index] != visibility)
+		recordChange(changes.visibility, index);
+
+	this->visibility[index] = visibility;
+	patchStepLayers(index);
+
+	// so the next vision update demotes it
+	if (visibility == VISIBLE && !walls[index])
+		visibleCells.push_back(index);
 }
 
 void Grid::setVisibility(GridPos pos, Visibility visibility) { return setVisibility(pos.row, pos.col, visibility); }
@@ -1405,7 +1572,7 @@ void Grid::SetOutlineColour(int row, int col, sf::Color colour)
 {
 	if (isOutOfBound(row, col))
 		return;
-	cells[row][col].rect.setOutlineColor(colour);
+	cells[getIndex(row, col)].rect.setOutlineColor(colour);
 }
 
 void Grid::SetOutlineColour(GridPos pos, sf::Color colour) { SetOutlineColour(pos.row, pos.col, colour); }
@@ -1416,7 +1583,7 @@ void Grid::SetColour(int row, int col, sf::Color colour)
 		return;
 	//crashIf(isOutOfBound(row, col), "Row: " + utl::quote(std::to_string(row)) + " Col: " + utl::quote(std::to_string(col)) + " is out of bound");
 
-	cells[row][col].rect.setFillColor(colour);
+	cells[getIndex(row, col)].rect.setFillColor(colour);
 }
 
 void Grid::SetColour(GridPos pos, sf::Color colour) { SetColour(pos.row, pos.col, colour); }
@@ -1443,14 +1610,14 @@ void Grid::setHighlight(GridPos pos)
 {
 	if (isOutOfBound(pos))
 		return;
-	cells[pos.row][pos.col].isHighlighted = true;
+	cells[getIndex(pos)].isHighlighted = true;
 }
 
 void Grid::setIntensity(GridPos pos, float _intensity)
 {
 	if (isOutOfBound(pos))
 		return;
-	cells[pos.row][pos.col].intensity = _intensity;
+	cells[getIndex(pos)].intensity = _intensity;
 }
 
 void Grid::setWidth(int newWidth)
@@ -1460,35 +1627,10 @@ void Grid::setWidth(int newWidth)
 	if (width == newWidth)
 		return;
 
-	bool isSmaller = newWidth < width;
 	for (Enemy *enemy : factory.getEntities<Enemy>())
 		factory.destroyEntity<Enemy>(enemy);
 
-	for (int i = 0; i < height; ++i)
-		if (isSmaller)
-		{
-			cells[i].erase(cells[i].begin() + newWidth, cells[i].end());
-			flowField[i].erase(flowField[i].begin() + newWidth, flowField[i].end());
-
-		}
-		else
-			for (int j = width; j < newWidth; ++j)
-			{
-				Cell cell;
-				cell.rect.setOrigin(cellSize / 2.f, cellSize / 2.f);
-				cell.rect.setSize(sf::Vector2f(cellSize, cellSize));
-				cell.rect.setPosition(j * cellSize, i * cellSize);
-				cell.rect.setFillColor(colors.at("Floor").first);
-				cell.rect.setOutlineColor(colors.at("Floor").second);
-				cell.rect.setOutlineThickness(4.f);
-				cell.pos = { i, j };
-				cells[i].push_back(cell);
-
-				flowField[i].emplace_back();
-				flowField[i].back().position = { i, j };
-			}
-
-	width = newWidth;
+	resize(height, newWidth);
 }
 
 void Grid::setHeight(int newHeight)
@@ -1498,39 +1640,66 @@ void Grid::setHeight(int newHeight)
 	if (height == newHeight)
 		return;
 
-	bool isSmaller = newHeight < height;
 	for (Enemy *enemy : factory.getEntities<Enemy>())
 		factory.destroyEntity<Enemy>(enemy);
 
-	if (isSmaller)
-	{
-		cells.erase(cells.begin() + newHeight, cells.end());
-		flowField.erase(flowField.begin() + newHeight, flowField.end());
-	}
-	else
-		for (int i = height; i < newHeight; ++i)
-		{
-			cells.push_back(std::vector<Cell>());
-			flowField.push_back(std::vector<flowFieldCell>());
+	resize(newHeight, width);
+}
 
-			for (int j = 0; j < width; ++j)
-			{
-				Cell cell;
-				cell.rect.setOrigin(cellSize / 2.f, cellSize / 2.f);
-				cell.rect.setSize(sf::Vector2f(cellSize, cellSize));
-				cell.rect.setPosition(j * cellSize, i * cellSize);
-				cell.rect.setFillColor(colors.at("Floor").first);
-				cell.rect.setOutlineColor(colors.at("Floor").second);
-				cell.rect.setOutlineThickness(4.f);
-				cell.pos = { i, j };
-				cells.back().push_back(cell);
-
-				flowField.back().emplace_back();
-				flowField.back().back().position = { i, j };
-			}
+void Grid::resize(int newHeight, int newWidth)
+{
+	size_t newSize = static_cast<size_t>(newHeight) * newWidth;
+	std::vector<unsigned char> newWalls(newSize, false);
+	std::vector<Visibility> newVisibility(newSize, UNEXPLORED);
+	std::vector<Cell> newCells(newSize);
+
+	// keep the overlapping part of the old grid
+	for (int row{}; row < std::min(height, newHeight); ++row)
+		for (int col{}; col < std::min(width, newWidth); ++col)
+		{
+			newWalls[row * newWidth + col] = walls[getIndex(row, col)];
+			newVisibility[row * newWidth + col] = visibility[getIndex(row, col)];
+			newCells[row * newWidth + col] = std::move(cells[getIndex(row, col)]);
 		}
 
+	int oldHeight = height, oldWidth = width;
 	height = newHeight;
+	width = newWidth;
+	walls = std::move(newWalls);
+	visibility = std::move(newVisibility);
+	cells = std::move(newCells);
+
+	distance.assign(newSize, std::numeric_limits<float>::max());
+	potential.assign(newSize, 0.f);
+	repulsion.assign(newSize, 0.f);
+	final.assign(newSize, 0.f);
+	direction.assign(newSize, Vec2{ 0, 0 });
+	directionGeneration.assign(newSize, 0);
+	visited.assign(newSize, false);
+	rebuildHeatMap = true;
+	rebuildStepLayers = true;
+	++wallVersion;
+	markAllUnexplored();
+	changes.isResized = changes.isMapReplaced = true;
+
+	for (int row{}; row < height; ++row)
+		for (int col{}; col < width; ++col)
+			if (row >= oldHeight || col >= oldWidth)
+				initCell(row, col, 4.f);
+}
+
+void Grid::initCell(int row, int col, float outlineThickness)
+{
+	Cell &cell = cells[getIndex(row, col)];
+	bool isWall = walls[getIndex(row, col)];
+
+	cell.rect.setOrigin(cellSize / 2.f, cellSize / 2.f);
+	cell.rect.setSize(sf::Vector2f(cellSize, cellSize));
+	cell.rect.setPosition(col * cellSize, row * cellSize); // was row *, col *
+	cell.rect.setFillColor(isWall ? colors.at("Wall").first : colors.at("Floor").first);
+	cell.rect.setOutlineColor(isWall ? colors.at("Wall").second : colors.at("Floor").second);
+	cell.rect.setOutlineThickness(outlineThickness);
+	cell.pos = { row, col };
 }
 
 void Grid::setWall(GridPos pos, bool _isWall)
@@ -1543,7 +1712,25 @@ void Grid::setWall(int row, int col, bool _isWall)
 	if (isOutOfBound(row, col))
 		return;
 
-	cells[row][col].isWall = _isWall;
+	if (walls[getIndex(row, col)] != _isWall)
+	{
+		heatChanges.push_back(getIndex(row, col));
+		recordChange(changes.walls, getIndex(row, col));
+		walls[getIndex(row, col)] = _isWall;
+		patchStepLayers(getIndex(row, col));
+
+		// an up to date jump table is patched around the cell instead of rebuilt on the next search
+		bool isJumpTableCurrent = jumpTableVersion == wallVersion;
+		++wallVersion;
+
+		if (isJumpTableCurrent)
+		{
+			pathFinder.patchJumpTable(height, width, walls, getIndex(row, col));
+			jumpTableVersion = wallVersion;
+		}
+	}
+
+	walls[getIndex(row, col)] = _isWall;
 	SetColour(row, col, _isWall ? colors.at("Wall").first : colors.at("Floor").first);
 }
 
@@ -1552,11 +1739,24 @@ void Grid::setWall(int row, int col, bool _isWall)
 // CHECKERS
 // ========
 
-const std::vector<std::vector<Cell>> &Grid::getCells() const
+const std::vector<unsigned char> &Grid::getWalls() const
 {
-	return cells;
+	return walls;
 }
 
+const std::vector<std::int16_t> &Grid::getJumpTable()
+{
+	updateJumpTable();
+	return pathFinder.getJumpTable();
+}
+
+int Grid::getIndex(int row, int col) const
+{
+	return row * width + col;
+}
+
+int Grid::getIndex(GridPos pos) const { return getIndex(pos.row, pos.col); }
+
 bool Grid::isWall(unsigned int row, unsigned int col) const
 {
 	
@@ -1570,7 +1770,7 @@ bool Grid::isWall(unsigned int row, unsigned int col) const
 	// assuming wall colour is black
 	//return cells[row][col].rect.getFillColor() == colors.at("Wall").first;
 
-	return cells[row][col].isWall;
+	return walls[getIndex(row, col)];
 }
 
 bool Grid::isWall(GridPos pos) const { return isWall(pos.row, pos.col); }
@@ -1596,53 +1796,14 @@ bool Grid::isClearPath(int row0, int col0, int row1, int col1) const
 	//if (isWall(row0, col0) || isWall(row1, col1))
 	//	return false;
 
-	// convert row0 and col0 to vectors 2D
-	Vec2 p0 = getWorldPos(row0, col0);
-
-	// convert row1 and col1 to vectors 2D
-	Vec2 p1 = getWorldPos(row1, col1);
-
-
-	// just use width since map is a square
-	float halfGridWidth = 0.5f * cellSize;
-
-	// puff up the grid width by the epsilon scale of itself
-	halfGridWidth += halfGridWidth * EPSILON;
-
-	// find min and max
-	int sx = row0 < row1 ? 1 : -1;
-	int sy = col0 < col1 ? 1 : -1;
+	if (row0 == row1 && col0 == col1)
+		return true;
 
-	for (int row = row0; (sx > 0) ? (row <= row1) : (row >= row1); row += sx)
-	{
-		for (int col = col0; (sy > 0) ? (col <= col1) : (col >= col1); col += sy)
+	// only the cells the line touches, stopping at the first wall
+	return traceLine(row1 - row0, col1 - col0, [this, row0, col0](int dr, int dc)
 		{
-			// skip non-wall cells
-			if (!isWall(row, col))
-				continue;
-
-			if (row == row0 && col == col0 || row == row1 && col == col1)
-				continue;
-
-			if ((row == row1 && col == col1) || (row == row0 && col == col0))
-				continue;
-
-			// convert minRow and minCol to vector 3D
-			Vec2 wallCenter = getWorldPos(row, col);
-
-			// get points of diagonal
-			Vec2 l1p0 = { wallCenter.x - halfGridWidth, wallCenter.y + halfGridWidth };
-			Vec2 l1p1 = { wallCenter.x + halfGridWidth, wallCenter.y - halfGridWidth };
-			Vec2 l2p0 = { wallCenter.x + halfGridWidth, wallCenter.y + halfGridWidth };
-			Vec2 l2p1 = { wallCenter.x - halfGridWidth, wallCenter.y - halfGridWidth };
-
-
-			if (lineIntersect(p0, p1, l1p0, l1p1) || lineIntersect(p0, p1, l2p0, l2p1))
-				return false;
-		}
-	}
-	return true;
-
+			return isWall(row0 + dr, col0 + dc);
+		});
 }
 
 bool Grid::isClearPath(GridPos lhs, GridPos rhs) const
@@ -1651,6 +1812,14 @@ bool Grid::isClearPath(GridPos lhs, GridPos rhs) const
 }
 
 
+void Grid::getClearPaths(GridPos origin, std::vector<GridPos> const &targets, std::vector<std::uint32_t> &clear) const
+{
+	static_assert(sizeof(GridPos) == 2 * sizeof(int), "targets are read as (row, col) int pairs");
+
+	clear.resize((targets.size() + 31) / 32);
+	kernel::traceLines(height, width, walls.data(), origin.row, origin.col, reinterpret_cast<int const *>(targets.data()), targets.size(), clear.data());
+}
+
 bool Grid::lineIntersect(const Vec2& line0P0, const Vec2& line0P1, const Vec2& line1P0, const Vec2& line1P1) const
 {
 	const float y4y3 = line1P1.y - line1P0.y;
@@ -15,11 +15,21 @@ written consent of DigiPen Institute of Technology is prohibited.
 #define GRID_H
 
 #include "Vector2D.h"
+#include "FieldSolver.h"
+#include "DiamondFilter.h"
+#include "LineOfSight.h"
+#include "SectorFlowField.h"
+#include "FlowFieldCache.h"
+#include "FlowFieldSet.h"
+#include "PathFinder.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <array>
 #include <unordered_map>
 #include <queue>
+#include <functional>
+#include <list>
+#include <memory>
 
 struct MapConfig
 {
@@ -60,7 +70,7 @@ struct RepulsionConfig
 	bool showRepulsionMap = false;
 };
 
-enum Visibility { UNEXPLORED, FOG, VISIBLE };
+enum Visibility : unsigned char { UNEXPLORED, FOG, VISIBLE };
 
 // data
 struct GridPos { int row{}, col{}; };
@@ -78,14 +88,27 @@ const std::unordered_map<std::string, std::pair<sf::Color, sf::Color>> colors //
 	{ "Highlight", { sf::Color(0, 180, 210), sf::Color(180, 210, 0) } }
 };
 
+// what changed in the grid since the changes were last published
+struct GridChanges
+{
+	std::vector<int> walls;				// cells whose wall flag flipped
+	std::vector<int> visibility;		// cells whose visibility changed
+	bool isExitMoved{ false };			// exit set, moved or removed
+	bool isResized{ false };			// width/ height changed, indices from before are stale
+	bool isMapReplaced{ false };		// any cell may have changed (new map, resize, generated, cleared, fog reset), the lists are left empty
+
+	bool isEmpty() const { return walls.empty() && visibility.empty() && !isExitMoved && !isResized && !isMapReplaced; }
+	void clear() { *this = GridChanges{}; }
+};
+
+using ChangeListener = std::function<void(GridChanges const &)>;
+
+// render and editor state of a cell (walls, visibility and fields live in the grid layers)
 struct Cell
 {
 	sf::RectangleShape rect{};				// rectangle tile 
-	Visibility visibility{ UNEXPLORED };	// visibility enum
 	bool isExit{ false };					// exit flag
 
-	bool isWall{false};
-
 	float intensity = 0.f; // fade white out after clicking
 	bool isHighlighted = false; // highlight border when moused over (does not work)
 
@@ -122,6 +145,21 @@ public:
 	// display heat map
 	bool showHeatMap{ false };
 
+	// only repair the parts of the heat map affected by wall/ fog changes
+	bool incrementalHeatMap{ true };
+
+	// solve full heat map rebuilds in tiles on the job system
+	bool parallelHeatMap{ false };
+
+	// path to the exit with the sector flow field instead of the full heat map
+	bool hierarchicalFlowField{ false };
+
+	// megabytes of solved exit fields kept for reuse
+	int flowFieldCacheMb{ 64 };
+
+	// search used for point to point paths
+	PathMethod pathMethod{ PathMethod::JPS_PLUS };
+
 	//bool showPotentialField{ false };
 
 	//bool usePotentialField{ false };
@@ -140,24 +178,55 @@ public:
 
 	//! update visibility of map based on radius
 	void updateVisibility(std::vector<std::pair<Vec2, Vec2>> const& entities, float fovRadius, float fovAngleDegrees, float visionCircleRadius);
+
+	//! cells whose visibility changed in the last updateVisibility
+	const std::vector<int> &getVisibilityChanges() const;
+
 	//! update heat map based on target position
 	void updateHeatMap(Vec2 target);
 
 	//! update heat map based on potentials
 	void updateHeatMap();
 
+	//! heat map and final map toward target, taken from the cache when the goal and the walls were solved before
+	void updateExitField(Vec2 target);
+
+	const FlowFieldCache &getFlowFieldCache() const;
+
+	//! goal of an enemy group's own flow field, solved by the next updateGroupFlowFields
+	void setGroupGoal(int group, Vec2 target);
+
+	//! solves the group flow fields whose goal or known walls changed, in parallel
+	void updateGroupFlowFields();
+
+	// @brief shortest path around the walls between two positions, for agents that don't need a whole flow field
+	// @return centers of the cells the path turns in after the start cell, ending with the goal cell. empty if there is no path
+	std::list<Vec2> findPath(Vec2 start, Vec2 goal, PathMethod method);
+
 	void updatePotentialMap();
 
+	//! zeroes the potential layer if an update wrote to it since it was last cleared
+	void clearPotentialMap();
+
+	//! adds repulsion around pos to the cells it can see
 	void updateRepulsionMap(GridPos pos, float radius, float strength);
 
+	//! wall repulsion from the cached wall distance transform, overwrites the layer
 	void updateRepulsionMap(float radius, float strength);
 
+	//! zeroes the repulsion layer if an update wrote to it since it was last cleared
+	void clearRepulsionMap();
+
 	void normalizeRepulsionMap();
 
 	void CombineMaps();
 
 	void resetHeatMap();
 
+	//! exit of the sector flow field, its sectors are solved when an enemy asks for a direction in them
+	void setFlowFieldGoal(Vec2 target);
+
+	//! evaluates the flow field of every cell now, getFlowFieldDir evaluates the cells it is asked for on its own
 	void generateFlowField();
 
 	void changeMap(const std::string& mapName);
@@ -175,6 +244,21 @@ public:
 	bool shouldEraseWall(GridPos currCell, GridPos prevCell, bool isFirst);
 	void setExit(GridPos pos);
 
+	// =======
+	// CHANGES
+	// =======
+
+	// @brief listener is called with the grid changes every time they are published
+	// @return id to unsubscribe with
+	int subscribe(ChangeListener listener);
+	void unsubscribe(int id);
+
+	//! hands the changes gathered since the last call to every listener and starts a new log, once per frame
+	void publishChanges();
+
+	//! changes gathered since the last publishChanges
+	const GridChanges &getChanges() const;
+
 	// =======
 	// Getters
 	// =======
@@ -193,10 +277,19 @@ public:
 
 	float distOfTwoCells(GridPos lhs, GridPos rhs)const;
 
-	const std::vector<std::vector<Cell>> &getCells() const; // for serialiser only
+	const std::vector<unsigned char> &getWalls() const; // for serialiser only
+
+	//! JPS+ jump table of the current walls, built first if it is out of date. for serialiser only
+	const std::vector<std::int16_t> &getJumpTable();
+
+	int getIndex(int row, int col) const;
+	int getIndex(GridPos pos) const;
 
+	// @brief flow field direction of a cell, computed from the final layer on the first query after it changed
 	Vec2 getFlowFieldDir(int row, int col) const;
 	Vec2 getFlowFieldDir(GridPos pos) const;
+	//! flow field direction of an enemy group, group -1 reads the shared field
+	Vec2 getFlowFieldDir(int group, GridPos pos) const;
 
 	std::vector<Cell *> getOrthNeighbors(GridPos pos, int steps = 2);
 	std::vector<Vec2> getNeighborWalls(GridPos pos);
@@ -204,6 +297,9 @@ public:
 
 	float getMaxDist() const;
 
+	//! number of unexplored cells in rows [row0, row1) x cols [col0, col1), clamped to the grid
+	int countUnexplored(int row0, int col0, int row1, int col1) const;
+
 
 	// =======
 	// Setters
@@ -226,6 +322,8 @@ public:
 
 	void setHeight(int newHeight); // which is actually width (fixed)
 
+	void resize(int newHeight, int newWidth);
+
 
 	void setWall(GridPos pos, bool _isWall);
 	void setWall(int row, int col, bool _isWall);
@@ -243,32 +341,45 @@ public:
 	bool isClearPath(int row0, int col0, int row1, int col1) const;
 	bool isClearPath(GridPos lhs, GridPos rhs) const;
 
+	// @brief isClearPath from origin to every target in one batch
+	// @param clear: resized to (targets + 31) / 32 words, bit i % 32 of word i / 32 is set when targets[i] is in sight
+	void getClearPaths(GridPos origin, std::vector<GridPos> const &targets, std::vector<std::uint32_t> &clear) const;
+
 	bool lineIntersect(const Vec2& line0P0, const Vec2& line0P1, const Vec2& line1P0, const Vec2& line1P1) const;
 
 	bool isExitFound() const { return exitFound; }
 private:
 
-	struct flowFieldCell
-	{
-		float distance{ std::numeric_limits<float>::max() };
-		float potential{ 0.f };
-		float repulsion{ 0.f };
-		float final{ 0.f };
-		vec2 direction{};
-		GridPos position{};
-
-		bool visited{ false };
-	};
-
-
-	struct potentialFieldCell
-	{
-		float potential{ std::numeric_limits<float>::max() };
-		vec2 direction{};
-		GridPos position{};
-
-		bool visited{ false };
-	};
+	void initCell(int row, int col, float outlineThickness);
+
+	bool isHeatMapEdge(int from, int i, int j) const;
+	//! rebuilds the step layers if the walls or the fog were replaced as a whole
+	void updateStepLayers();
+	//! brings the step layers of one cell up to date after its wall or unexplored state flipped
+	void patchStepLayers(int index);
+	void rebuildHeat();
+	void repairHeat();
+	void propagateHeat();
+
+	//! marks a cell in sight as visible
+	void revealCell(int index);
+	//! rebuilds the vision update state after the visibility or wall layer was replaced
+	void collectVisibleCells();
+	//! adds a cell to a change list, too many changes turn into isMapReplaced
+	void recordChange(std::vector<int> &list, int index);
+
+	//! 8-neighbour gradient of the final layer at a cell, the stored direction for cells without one
+	Vec2 computeFlowFieldDir(int row, int col) const;
+	//! whether getFlowFieldDir reads the sector flow field
+	bool isSectorFlowField() const;
+	//! hands the known walls of a new or replaced map to the sector flow field
+	void resetSectorFlowField();
+	//! rebuilds the JPS+ jump table if the walls changed in a way it was not patched for
+	void updateJumpTable();
+
+	void markUnexplored(int index);
+	void markAllUnexplored();
+	void updateUnexploredSat() const;
 
 	int height, width;	// width and height of the grid
 	float cellSize;		// single cell width/ height
@@ -276,12 +387,84 @@ private:
 
 	bool exitFound{ false };
 
-	std::vector<std::vector<Cell>> cells;				// grid cells
-	std::vector<std::vector<flowFieldCell>> flowField;	// heatmap and flowfield container
-
-	std::vector<std::vector<potentialFieldCell>> potentialField; // potential field container
-
-	std::queue<flowFieldCell*> openList;				// open list to generate heat map
+	// ===========
+	// GRID LAYERS
+	// ===========
+	// flat row-major arrays (index = row * width + col)
+	std::vector<unsigned char> walls;		// wall flags
+	std::vector<Visibility> visibility;		// fog of war state
+	std::vector<float> distance;			// heat map
+	std::vector<float> potential;			// potential field
+	std::vector<float> repulsion;			// repulsion field
+	bool hasPotential{}, hasRepulsion{};	// the layers hold something other than 0
+	std::vector<float> final;				// combined map the flow field is generated from
+	mutable std::vector<Vec2> direction;	// flow field, evaluated lazily
+
+	// a direction is up to date when its stamp matches finalGeneration, bumped whenever final is rewritten
+	mutable std::vector<unsigned> directionGeneration;
+	unsigned finalGeneration{ 1 };
+
+	// exit flow field for large maps, kept in step with the known walls by publishChanges
+	mutable SectorFlowField sectorFlowField;
+
+	FlowFieldCache flowFieldCache;			// exit and group fields by goal and wall versions
+	FlowFieldCache::Key exitFieldKey;		// field in the distance/ final layers, goal -1 once they were overwritten
+
+	FlowFieldSet groupFlowFields;			// one field per enemy group over the known walls
+	unsigned groupWallVersion{};			// wallVersion the group layers were built for
+	unsigned groupKnownWallVersion{};		// knownWallVersion the group layers were built for
+
+	PathFinder pathFinder;					// point to point searches over the walls
+	unsigned jumpTableVersion{};			// wallVersion the JPS+ jump table is up to date with
+	std::vector<int> pathCells;				// scratch path of the last search
+
+	std::vector<Cell> cells;				// render and map generation state (cold)
+
+	std::vector<unsigned char> visited;		// scratch flags to generate heat map
+
+	// exploration heat map kept between frames so it can be repaired incrementally
+	std::vector<float> heat;				// raw distance to the nearest unexplored cell
+	std::vector<int> heatParent;			// neighbour the distance came from (-1 for sources)
+	std::vector<int> heatChanges;			// cells whose wall/ unexplored state changed since the last update
+	std::vector<int> heatInvalid;			// scratch list of cells invalidated by a repair
+	bool rebuildHeatMap{ true };			// set when too much changed to repair
+	BucketQueue heatQueue;					// open list shared by both heat maps
+	TiledFieldSolver tiledSolver;			// parallel solver for large maps
+
+	// summed-area table of unexplored cells, (height + 1) x (width + 1) with a zero first row/ column.
+	// flips only mark the table stale from their row/ column on and it is brought up to date on the next query
+	mutable std::vector<int> unexploredSat;
+	mutable int satDirtyRow{}, satDirtyCol{};	// first stale row/ column (height/ width when up to date)
+
+	std::vector<std::pair<int, int>> potentialCentres;	// centers of the unknown blocks
+	DiamondFilter potentialFilter;			// spreads the potential around the centers
+
+	// step layers of every field solved over the grid, each entry only depends on its own cell so
+	// single cell edits patch them and only replacing the walls or the fog as a whole rebuilds them
+	std::vector<unsigned char> canEnter;		// cells a heat map step may end in
+	std::vector<unsigned char> knownCanEnter;	// cells an exit or group field step may end in
+	std::vector<unsigned char> blocksCorner;	// cells a diagonal step may not squeeze past (the known walls)
+	bool rebuildStepLayers{ true };			// set when the walls or the fog were replaced
+
+	// exact distance to the nearest wall, recomputed when the walls changed since it was built
+	std::vector<float> wallDistance;		// squared, in cells
+	unsigned wallVersion{ 1 };				// bumped on every wall edit
+	unsigned wallDistanceVersion{};			// wallVersion wallDistance was built for
+	unsigned knownWallVersion{ 1 };			// bumped when a wall is found or hidden in the fog again
+	LosCache losCache;						// what each enemy cell can see within the repulsion radius
+	RayFan fovFan;							// line of sight of every offset within the vision radii
+
+	// vision updates only touch the cells that entered or left view
+	std::vector<int> visibleCells;			// non-wall cells made visible by the last vision update
+	std::vector<int> previousVisibleCells;	// scratch copy of visibleCells from the update before
+	std::vector<unsigned> seenGeneration;	// vision update each cell was last seen in
+	unsigned visionGeneration{};
+	unsigned visionWallVersion{};			// wallVersion visibleCells was collected for
+	std::vector<int> visibilityChanges;		// cells whose visibility changed in the last vision update
+
+	GridChanges changes;					// change log since the last publishChanges
+	std::vector<std::pair<int, ChangeListener>> listeners;
+	int nextListenerId{};
 
 	std::vector<Cell *> waypoints; // debug;
 	std::vector<std::unique_ptr<sf::Drawable>> debugRadius;
@@ -0,0 +1,103 @@
+//==============================================================================
+/*!
+\file		JobSystem.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the JobSystem class
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "JobSystem.h"
+#include "Utility.h"
+
+JobSystem::JobSystem(unsigned threadCount)
+{
+	// the calling thread takes part in every loop
+	for (unsigned i{ 1 }; i < threadCount; ++i)
+		workers.emplace_back(&JobSystem::workerLoop, this);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+
+	wake.notify_all();
+
+	for (std::thread &worker : workers)
+		worker.join();
+}
+
+void JobSystem::parallelFor(int count, std::function<void(int)> const &func)
+{
+	// not worth waking anyone up
+	if (workers.empty() || count <= 1)
+	{
+		for (int i{}; i < count; ++i)
+			func(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		crashIf(isRunning, "JobSystem::parallelFor can't be nested");
+
+		isRunning = true;
+		job = &func;
+		jobCount = count;
+		nextJob = 0;
+		busyWorkers = static_cast<int>(workers.size());
+		++generation;
+	}
+
+	wake.notify_all();
+	runJobs();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return busyWorkers == 0; });
+
+	job = nullptr;
+	isRunning = false;
+}
+
+unsigned JobSystem::getThreadCount() const
+{
+	return static_cast<unsigned>(workers.size()) + 1;
+}
+
+void JobSystem::workerLoop()
+{
+	unsigned seenGeneration{};
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&] { return quit || generation != seenGeneration; });
+
+			if (quit)
+				return;
+
+			seenGeneration = generation;
+		}
+
+		runJobs();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busyWorkers == 0)
+			done.notify_one();
+	}
+}
+
+void JobSystem::runJobs()
+{
+	// grab indices until the loop is exhausted
+	for (int i = nextJob++; i < jobCount; i = nextJob++)
+		(*job)(i);
+}
@@ -0,0 +1,59 @@
+//==============================================================================
+/*!
+\file		JobSystem.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the JobSystem class
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed pool of worker threads that split parallel loops with the calling thread
+class JobSystem
+{
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;		// signals workers that a new loop started (or to quit)
+	std::condition_variable done;		// signals the caller that every worker left the loop
+
+	std::function<void(int)> const *job{ nullptr };
+	int jobCount{};
+	std::atomic<int> nextJob{};
+	int busyWorkers{};
+	unsigned generation{};				// bumped for every loop so workers don't run one twice
+	bool isRunning{ false };			// a loop is in flight (loops can't be nested)
+	bool quit{ false };
+
+	void workerLoop();
+	void runJobs();
+
+public:
+
+	//! start the pool with threadCount threads in total, the calling thread included
+	JobSystem(unsigned threadCount = std::thread::hardware_concurrency());
+	~JobSystem();
+
+	JobSystem(JobSystem const &) = delete;
+	JobSystem &operator=(JobSystem const &) = delete;
+
+	//! call func(0) to func(count - 1) across the pool and wait for all of them
+	void parallelFor(int count, std::function<void(int)> const &func);
+
+	//! number of threads a loop is split across (workers + the caller)
+	unsigned getThreadCount() const;
+};
+
+#endif // !JOBSYSTEM_H
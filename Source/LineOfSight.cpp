@@ -0,0 +1,100 @@
+//==============================================================================
+/*!
+\file		LineOfSight.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the shadowcasting line of sight functionalities
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "LineOfSight.h"
+
+// =======
+// RAY FAN
+// =======
+
+void RayFan::build(int _reach)
+{
+	if (reach == _reach)
+		return;
+
+	reach = _reach;
+	rays.clear();
+	blockers.clear();
+
+	for (int dr{ -reach }; dr <= reach; ++dr)
+		for (int dc{ -reach }; dc <= reach; ++dc)
+		{
+			Ray ray{ dr, dc, static_cast<int>(blockers.size()), 0 };
+
+			// nearest blockers first so casts stop early
+			if (dr || dc)
+				traceLine(dr, dc, [this](int row, int col)
+					{
+						blockers.push_back({ row, col });
+						return false;
+					});
+
+			ray.blockerCount = static_cast<int>(blockers.size()) - ray.firstBlocker;
+			rays.push_back(ray);
+		}
+}
+
+// =========
+// LOS CACHE
+// =========
+
+bool LosCache::Mask::isVisible(int row, int col) const
+{
+	row -= row0;
+	col -= col0;
+
+	if (row < 0 || col < 0 || row >= size || col >= size)
+		return false;
+
+	return bits[row * wordsPerRow + col / 32] >> (col % 32) & 1u;
+}
+
+LosCache::Mask const &LosCache::get(int height, int _width, unsigned char const *walls, unsigned wallVersion, int row, int col, float _radius)
+{
+	if (version != wallVersion || radius != _radius || width != _width || masks.size() >= MAX_MASKS)
+	{
+		masks.clear();
+		version = wallVersion;
+		radius = _radius;
+		width = _width;
+	}
+
+	auto [it, isNew] = masks.try_emplace(row * width + col);
+	Mask &mask = it->second;
+
+	if (!isNew)
+		return mask;
+
+	int reach = radius > 0.f ? static_cast<int>(radius) : 0;
+
+	mask.row0 = row - reach;
+	mask.col0 = col - reach;
+	mask.size = 2 * reach + 1;
+	mask.wordsPerRow = (mask.size + 31) / 32;
+	mask.bits.assign(mask.size * mask.wordsPerRow, 0u);
+
+	caster.cast(height, width, walls, row, col, radius, [&mask](int r, int c)
+		{
+			r -= mask.row0;
+			c -= mask.col0;
+			mask.bits[r * mask.wordsPerRow + c / 32] |= 1u << (c % 32);
+		});
+
+	return mask;
+}
+
+void LosCache::clear()
+{
+	masks.clear();
+	radius = -1.f;
+}
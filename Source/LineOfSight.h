@@ -0,0 +1,338 @@
+//==============================================================================
+/*!
+\file		LineOfSight.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the shadowcasting line of sight functionalities
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef LINEOFSIGHT_H
+#define LINEOFSIGHT_H
+
+#include "MathLib.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <climits>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// ============
+// SHADOWCASTER
+// ============
+
+// symmetric shadowcasting (A. Ford): sweeps the four quadrants around an origin row by row, narrowing
+// the visible slope range at every wall. a floor cell is seen iff its centre is inside the range, which makes
+// sight symmetric, walls are seen if any part of them is. every cell is visited once per sweep, O(radius^2)
+class Shadowcaster
+{
+	struct Slope { int num, den; };		// num / den, den > 0
+	struct Row { int depth; Slope start, end; };
+
+	std::vector<Row> rows;				// rows left to scan in the current quadrant
+
+	//! slope through the left edge of column col at depth
+	static Slope edge(int depth, int col) { return { 2 * col - 1, 2 * depth }; }
+	static int floorDiv(int a, int b) { return a / b - (a % b != 0 && (a < 0) != (b < 0)); }
+	static int ceilDiv(int a, int b) { return -floorDiv(-a, b); }
+
+public:
+
+	// @brief calls visit(row, col) for every cell in sight within radius cells (euclidean) of the origin
+	// @param walls: height * width row-major blocking flags, outside the grid blocks sight
+	// @note cells on the quadrant diagonals and the origin may be visited more than once
+	template <typename Visit>
+	void cast(int height, int width, unsigned char const *walls, int originRow, int originCol, float radius, Visit &&visit);
+};
+
+template <typename Visit>
+void Shadowcaster::cast(int height, int width, unsigned char const *walls, int originRow, int originCol, float radius, Visit &&visit)
+{
+	if (originRow < 0 || originCol < 0 || originRow >= height || originCol >= width || !(radius >= 0.f))
+		return;
+
+	visit(originRow, originCol);
+
+	// grid offset of one step in depth and one step along the row for north, south, east and west
+	constexpr int DEPTH_STEP[4][2] = { { -1, 0 }, { 1, 0 }, { 0, 1 }, { 0, -1 } };
+	constexpr int COL_STEP[4][2] = { { 0, 1 }, { 0, 1 }, { 1, 0 }, { 1, 0 } };
+
+	int maxDepth = static_cast<int>(radius);
+	float radiusSq = radius * radius;
+
+	for (int quadrant{}; quadrant < 4; ++quadrant)
+	{
+		rows.clear();
+		rows.push_back(Row{ 1, { -1, 1 }, { 1, 1 } });
+
+		while (!rows.empty())
+		{
+			Row current = rows.back();
+			rows.pop_back();
+
+			if (current.depth > maxDepth)
+				continue;
+
+			int depth = current.depth;
+
+			// columns whose centres round into the slope range
+			int minCol = floorDiv(2 * depth * current.start.num + current.start.den, 2 * current.start.den);
+			int maxCol = ceilDiv(2 * depth * current.end.num - current.end.den, 2 * current.end.den);
+
+			enum { NONE, FLOOR, WALL } previous = NONE;
+
+			for (int col{ minCol }; col <= maxCol; ++col)
+			{
+				int row = originRow + depth * DEPTH_STEP[quadrant][0] + col * COL_STEP[quadrant][0];
+				int column = originCol + depth * DEPTH_STEP[quadrant][1] + col * COL_STEP[quadrant][1];
+				bool isInside = row >= 0 && column >= 0 && row < height && column < width;
+				bool isWall = !isInside || walls[row * width + column];
+
+				bool isSymmetric = col * current.start.den >= depth * current.start.num && col * current.end.den <= depth * current.end.num;
+
+				if (isInside && (isWall || isSymmetric) && static_cast<float>(depth * depth + col * col) <= radiusSq)
+					visit(row, column);
+
+				if (previous == WALL && !isWall)
+					current.start = edge(depth, col);
+
+				if (previous == FLOOR && isWall)
+					rows.push_back(Row{ depth + 1, current.start, edge(depth, col) });
+
+				previous = isWall ? WALL : FLOOR;
+			}
+
+			if (previous == FLOOR)
+				rows.push_back(Row{ depth + 1, current.start, current.end });
+		}
+	}
+}
+
+// ==========
+// LINE TRACE
+// ==========
+
+// @brief walks the cells between the origin cell and the cell (dr, dc) away that the straight line between their
+//        centres touches, in order (Amanatides & Woo). a line through a corner touches both cells beside it, which
+//        is what Grid::isClearPath always treated as blocked. the crossings are compared as integers, so it is exact
+// @param isBlocked: called with the (dr, dc) offset of every touched cell except the two ends
+// @return false as soon as isBlocked returns true
+template <typename IsBlocked>
+bool traceLine(int dr, int dc, IsBlocked &&isBlocked)
+{
+	int stepRow = dr < 0 ? -1 : 1, stepCol = dc < 0 ? -1 : 1;
+	long long rows = std::abs(dr), cols = std::abs(dc);
+
+	// the line crosses its (i + 1)th column edge at t = (2i + 1) / (2 cols) and (j + 1)th row edge at (2j + 1) / (2 rows),
+	// both scaled by 2 rows cols here
+	long long nextCol = cols ? rows : LLONG_MAX;
+	long long nextRow = rows ? cols : LLONG_MAX;
+	int row{}, col{};
+
+	while (true)
+	{
+		if (nextCol < nextRow)
+		{
+			col += stepCol;
+			nextCol += 2 * rows;
+		}
+		else if (nextRow < nextCol)
+		{
+			row += stepRow;
+			nextRow += 2 * cols;
+		}
+		else
+		{
+			// through a corner
+			if (isBlocked(row, col + stepCol) || isBlocked(row + stepRow, col))
+				return false;
+
+			row += stepRow;
+			col += stepCol;
+			nextCol += 2 * rows;
+			nextRow += 2 * cols;
+		}
+
+		if (row == dr && col == dc)
+			return true;
+
+		if (isBlocked(row, col))
+			return false;
+	}
+}
+
+// =======
+// RAY FAN
+// =======
+
+// every offset within reach of an origin together with the cells traceLine touches on the way to it. sight only
+// depends on the offset, so the fan is built once and one cast per origin just checks the blockers
+class RayFan
+{
+	struct Ray
+	{
+		int dr, dc;							// target offset from the origin
+		int firstBlocker, blockerCount;		// range in blockers
+	};
+
+	std::vector<Ray> rays;
+	std::vector<std::pair<int, int>> blockers;	// (dr, dc) of the cells between an origin and each target
+	int reach{ -1 };
+
+public:
+
+	// @brief builds the rays for every offset in the (2 * reach + 1)^2 square, no-op if already built for reach
+	void build(int _reach);
+
+	int getReach() const { return reach; }
+
+	// @brief calls visit(row, col) for every cell in the grid with inView(dr, dc) and a clear line of sight
+	// @param walls: height * width row-major blocking flags, outside the grid blocks sight
+	template <typename InView, typename Visit>
+	void cast(int height, int width, unsigned char const *walls, int originRow, int originCol, InView &&inView, Visit &&visit) const;
+};
+
+template <typename InView, typename Visit>
+void RayFan::cast(int height, int width, unsigned char const *walls, int originRow, int originCol, InView &&inView, Visit &&visit) const
+{
+	for (Ray const &ray : rays)
+	{
+		int row = originRow + ray.dr, col = originCol + ray.dc;
+
+		if (row < 0 || col < 0 || row >= height || col >= width || !inView(ray.dr, ray.dc))
+			continue;
+
+		bool isClear = true;
+
+		for (int i{ ray.firstBlocker }; isClear && i < ray.firstBlocker + ray.blockerCount; ++i)
+		{
+			int r = originRow + blockers[i].first, c = originCol + blockers[i].second;
+			isClear = r >= 0 && c >= 0 && r < height && c < width && !walls[r * width + c];
+		}
+
+		if (isClear)
+			visit(row, col);
+	}
+}
+
+// @brief calls visit(row, col) for every cell an entity at pos sees: within coneRadius and halfAngle (radians) of
+//        direction or within circleRadius, and in sight of the entity's cell. cells are tested inside the square
+//        reach (radius / cellSize) of each radius only, like the vision update always did
+// @param fan: built for the larger of the two reaches
+template <typename Visit>
+void castVision(RayFan const &fan, int height, int width, unsigned char const *walls, float cellSize,
+	Vec2 pos, Vec2 direction, float coneRadius, float halfAngle, float circleRadius, Visit &&visit)
+{
+	int coneReach = static_cast<int>(coneRadius / cellSize);
+	int circleReach = static_cast<int>(circleRadius / cellSize);
+	float cosHalfAngle = std::cos(halfAngle);
+
+	// same rounding as Grid::getGridPos/ getWorldPos
+	int row = static_cast<int>((pos.y + 0.5f * cellSize) / cellSize);
+	int col = static_cast<int>((pos.x + 0.5f * cellSize) / cellSize);
+
+	float directionAngle = std::atan2(direction.y, direction.x);
+	Vec2 facing{ std::cos(directionAngle), std::sin(directionAngle) };
+
+	auto inView = [&](int dr, int dc)
+		{
+			Vec2 toCell{ (col + dc) * cellSize - pos.x, (row + dr) * cellSize - pos.y };
+			float distance = toCell.Length();
+
+			if (std::abs(dr) <= circleReach && std::abs(dc) <= circleReach && distance <= circleRadius)
+				return true;
+
+			if (std::abs(dr) > coneReach || std::abs(dc) > coneReach || distance > coneRadius)
+				return false;
+
+			// the angle to the cell is within halfAngle when its cosine is at least cos(halfAngle)
+			return halfAngle >= PI || facing.x * toCell.x + facing.y * toCell.y >= cosHalfAngle * distance;
+		};
+
+	fan.cast(height, width, walls, row, col, inView, visit);
+}
+
+//! reach the ray fan has to be built for by castVision
+inline int getVisionReach(float cellSize, float coneRadius, float circleRadius)
+{
+	return static_cast<int>(std::max(coneRadius, circleRadius) / cellSize);
+}
+
+// =========
+// LOS CACHE
+// =========
+
+// line of sight masks keyed by source cell for one radius, built by shadowcasting on first use.
+// every mask is dropped when the radius or the walls change
+class LosCache
+{
+public:
+
+	// cells in sight of a source, one bit per cell of the (2 * radius + 1)^2 square around it
+	struct Mask
+	{
+		int row0{}, col0{};					// grid cell of the first bit
+		int size{};							// rows and columns covered
+		int wordsPerRow{};
+		std::vector<std::uint32_t> bits;
+
+		bool isVisible(int row, int col) const;
+
+		//! calls visit(row, col) for every cell in sight, row by row
+		template <typename Visit>
+		void forEach(Visit &&visit) const;
+	};
+
+	// @brief mask of the cells within radius cells of (row, col) with a clear line of sight
+	// @param wallVersion: bumped by the caller on every wall edit
+	Mask const &get(int height, int width, unsigned char const *walls, unsigned wallVersion, int row, int col, float radius);
+
+	void clear();
+
+	size_t getSize() const { return masks.size(); }
+
+private:
+
+	std::unordered_map<int, Mask> masks;	// keyed by row * width + col of the source
+	Shadowcaster caster;
+	unsigned version{};						// wall version the masks were built for
+	float radius{ -1.f };					// radius the masks were built for
+	int width{};							// grid width the keys were made with
+
+	static constexpr size_t MAX_MASKS = 1 << 14;	// everything is dropped past this
+
+	//! index of the lowest set bit
+	static int lowestBit(std::uint32_t bits);
+};
+
+inline int LosCache::lowestBit(std::uint32_t bits)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(bits);
+#endif
+}
+
+template <typename Visit>
+void LosCache::Mask::forEach(Visit &&visit) const
+{
+	for (int row{}; row < size; ++row)
+		for (int word{}; word < wordsPerRow; ++word)
+			for (std::uint32_t set = bits[row * wordsPerRow + word]; set; set &= set - 1)
+				visit(row0 + row, col0 + word * 32 + lowestBit(set));
+}
+
+#endif // !LINEOFSIGHT_H
@@ -15,9 +15,31 @@ written consent of DigiPen Institute of Technology is prohibited.
 #include "Grid.h"
 #include <fstream>
 #include <filesystem>
+#include <cstring>
 
 extern Grid grid;
 
+namespace
+{
+	// header of a .jps file, the table is only used if it matches the map it sits next to
+	struct JumpTableHeader
+	{
+		char magic[4]{ 'J', 'P', 'S', '+' };
+		std::uint32_t version{ 1 };
+		std::int32_t rows{}, cols{};
+		std::uint32_t wallHash{};
+	};
+
+	//! FNV-1a of the wall layer, tells a table apart from one saved for walls edited since
+	std::uint32_t hashWalls(const std::vector<unsigned char> &walls)
+	{
+		std::uint32_t hash = 2166136261u;
+		for (unsigned char wall : walls)
+			hash = (hash ^ (wall ? 1u : 0u)) * 16777619u;
+		return hash;
+	}
+}
+
 Loader::Loader()
 {
 	// register colours
@@ -26,13 +48,13 @@ Loader::Loader()
 		colorNames[color] = str;
 }
 
-const std::vector<std::vector<bool>> &Loader::getMap(const std::string &mapName)
+const MapData &Loader::getMap(const std::string &mapName)
 {
 	crashIf(!maps.count(mapName), "Map " + utl::quote(mapName) + " does not exist");
 	return maps.at(mapName);
 }
 
-const std::unordered_map<std::string, std::vector<std::vector<bool>>> &Loader::getMaps()
+const std::unordered_map<std::string, MapData> &Loader::getMaps()
 {
 	return maps;
 }
@@ -46,6 +68,10 @@ void Loader::loadMaps()
 {
 	for (const auto &entry : std::filesystem::directory_iterator("../Assets/Data/Maps"))
 	{
+		// jump tables live next to the maps
+		if (entry.path().extension() != ".txt")
+			continue;
+
 		const std::string mapName = entry.path().stem().string();
 		std::ifstream ifs(entry.path());
 		crashIf(!ifs, "Unable to open " + mapName + ".txt for reading");
@@ -56,67 +82,102 @@ void Loader::loadMaps()
 		std::getline(ifs, temp); // get nl
 
 		bool input;
-		maps[mapName] = std::vector<std::vector<bool>>();
-		std::vector<std::vector<bool>> &currMap = maps.at(mapName);
+		maps[mapName] = MapData{ static_cast<int>(rows), static_cast<int>(cols), {}, {} };
+		MapData &currMap = maps.at(mapName);
+		currMap.walls.reserve(rows * cols);
 		
 		for (size_t i = 0; i < rows; ++i)
 		{
-			currMap.push_back(std::vector<bool>());
-
 			for (size_t j = 0; j < cols; ++j)
 			{
 				ifs >> input;
-				currMap.back().push_back(input);
+				currMap.walls.push_back(input);
 			}
 
 			std::getline(ifs, temp); // get nl
 		}
+
+		loadJumpTable(mapName, currMap);
 	}
 }
 
+void Loader::loadJumpTable(const std::string &mapName, MapData &map)
+{
+	std::ifstream ifs("../Assets/Data/Maps/" + mapName + ".jps", std::ios::binary);
+	JumpTableHeader header, expected;
+	expected.rows = map.rows;
+	expected.cols = map.cols;
+	expected.wallHash = hashWalls(map.walls);
+
+	if (ifs.read(reinterpret_cast<char *>(&header), sizeof(header)) && !std::memcmp(&header, &expected, sizeof(header)))
+	{
+		map.jumps.resize(static_cast<size_t>(map.rows) * map.cols * 8);
+		if (ifs.read(reinterpret_cast<char *>(map.jumps.data()), map.jumps.size() * sizeof(std::int16_t)))
+			return;
+	}
+
+	// missing, from an older version or for other walls. the grid builds the table in memory
+	// on the first search that needs it and the next saveMap writes it out
+	map.jumps.clear();
+}
+
+void Loader::saveJumpTable(const std::string &mapName, const MapData &map)
+{
+	// only a cache, a map that can't have one is just slower to load
+	std::ofstream ofs("../Assets/Data/Maps/" + mapName + ".jps", std::ios::binary);
+	if (!ofs)
+		return;
+
+	JumpTableHeader header;
+	header.rows = map.rows;
+	header.cols = map.cols;
+	header.wallHash = hashWalls(map.walls);
+
+	ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	ofs.write(reinterpret_cast<const char *>(map.jumps.data()), map.jumps.size() * sizeof(std::int16_t));
+}
+
 void Loader::saveMap(const std::string& mapName)
 {
-	const std::vector<std::vector<Cell>> &cells = grid.getCells();
-	maps[mapName] = std::vector<std::vector<bool>>();
-	std::vector<std::vector<bool>> &currMap = maps.at(mapName);
+	const std::vector<unsigned char> &walls = grid.getWalls();
+	maps[mapName] = MapData{ grid.getHeight(), grid.getWidth(), walls, grid.getJumpTable() };
 	std::ofstream ofs("../Assets/Data/Maps/" + mapName + ".txt");
 	crashIf(!ofs, "Unable to open " + mapName + ".txt for overwriting");
 
-	size_t newWidth = cells.size() ? cells[0].size() : 0;
-	for (const std::vector<Cell> &row : cells)
-		crashIf(newWidth != row.size(), "Map " + utl::quote(mapName) + " has rows of different sizes");
-	ofs << cells.size() << ' ' << newWidth << nl;
+	crashIf(walls.size() != static_cast<size_t>(grid.getHeight()) * grid.getWidth(), "Map " + utl::quote(mapName) + " has rows of different sizes");
+	ofs << grid.getHeight() << ' ' << grid.getWidth() << nl;
 
-	for (const std::vector<Cell> &row : cells)
+	for (int row = 0; row < grid.getHeight(); ++row)
 	{
-		currMap.push_back(std::vector<bool>());
-
-		for (const Cell &cell : row)
-		{
-			ofs << cell.isWall << ' ';
-			currMap.back().push_back(cell.isWall);
-		}
+		for (int col = 0; col < grid.getWidth(); ++col)
+			ofs << static_cast<bool>(walls[grid.getIndex(row, col)]) << ' ';
 
 		ofs << nl;
 	}
+
+	saveJumpTable(mapName, maps.at(mapName));
 }
 
 void Loader::deleteMap(const std::string &mapName)
 {
 	crashIf(!maps.count(mapName), "Map " + utl::quote(mapName) + " does not exist");
 	std::filesystem::remove("../Assets/Data/Maps/" + mapName + ".txt");
+	std::filesystem::remove("../Assets/Data/Maps/" + mapName + ".jps");
 	maps.erase(mapName);
 }
 
 void Loader::renameMap(const std::string &oldName, const std::string &newName)
 {
 	crashIf(!maps.count(oldName), "Map " + utl::quote(oldName) + " does not exist");
-	const std::vector<std::vector<bool>> map = getMap(oldName); // not a reference
+	const MapData map = getMap(oldName); // not a reference
 
 	try
 	{
 		std::filesystem::copy("../Assets/Data/Maps/" + oldName + ".txt", "../Assets/Data/Maps/" +
 			newName + ".txt");
+		if (std::filesystem::exists("../Assets/Data/Maps/" + oldName + ".jps"))
+			std::filesystem::copy("../Assets/Data/Maps/" + oldName + ".jps", "../Assets/Data/Maps/" +
+				newName + ".jps");
 	}
 	catch (const std::exception &e)
 	{
@@ -17,6 +17,16 @@ written consent of DigiPen Institute of Technology is prohibited.
 
 #include "Utility.h"
 #include <unordered_map>
+#include <cstdint>
+
+// wall layout of a map, stored row-major like the grid layers
+struct MapData
+{
+	int rows = 0;
+	int cols = 0;
+	std::vector<unsigned char> walls;
+	std::vector<std::int16_t> jumps; // JPS+ jump distances (PathFinder), 8 per cell, kept in a .jps file next to the map. empty if there was none
+};
 
 class Loader
 {
@@ -50,14 +60,19 @@ class Loader
 	};
 
 	std::unordered_map<std::pair<sf::Color, sf::Color>, std::string, PairColorHash, PairColorEqual> colorNames;
-	std::unordered_map<std::string, std::vector<std::vector<bool>>> maps;
+	std::unordered_map<std::string, MapData> maps;
+
+	//! reads the jump table saved next to a map, leaves it empty if it is missing or for other walls
+	void loadJumpTable(const std::string &mapName, MapData &map);
+	//! writes the jump table next to a map, skipped if the file can't be written
+	void saveJumpTable(const std::string &mapName, const MapData &map);
 
 public:
 
 	Loader();
 
-	const std::unordered_map<std::string, std::vector<std::vector<bool>>> &getMaps();
-	const std::vector<std::vector<bool>> &getMap(const std::string &mapName);
+	const std::unordered_map<std::string, MapData> &getMaps();
+	const MapData &getMap(const std::string &mapName);
 	bool doesMapExist(const std::string &mapName);
 
 	void loadMaps();
@@ -0,0 +1,68 @@
+//==============================================================================
+/*!
+\file		ObjectPool.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the fixed size slab allocator
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "ObjectPool.h"
+#include "Utility.h"
+#include <algorithm>
+
+ObjectPool::ObjectPool(size_t objectSize, size_t _slotsPerSlab)
+	: slotsPerSlab(std::max<size_t>(_slotsPerSlab, 1))
+{
+	// whole max_align_t units, so every slot is aligned for anything and can hold the free list link.
+	// the unit is its size, which may be larger than its alignment, since the slabs are arrays of it
+	constexpr size_t UNIT = sizeof(std::max_align_t);
+	static_assert(UNIT % alignof(std::max_align_t) == 0, "max_align_t units must stay aligned");
+	slotSize = (std::max(objectSize, sizeof(void *)) + UNIT - 1) / UNIT * UNIT;
+	crashIf(slotSize < objectSize || slotSize < sizeof(void *), "Pool slots are too small for their objects");
+}
+
+void ObjectPool::addSlab(size_t slots)
+{
+	size_t units = slotSize / sizeof(std::max_align_t);
+	slabs.emplace_back(new std::max_align_t[slots * units]);
+	std::max_align_t *slab = slabs.back().get();
+
+	// pushed back to front so the slots are handed out in address order
+	for (size_t i{ slots }; i > 0; --i)
+	{
+		void *slot = slab + (i - 1) * units;
+		*static_cast<void **>(slot) = freeSlots;
+		freeSlots = slot;
+	}
+
+	capacity += slots;
+}
+
+void *ObjectPool::allocate()
+{
+	if (!freeSlots)
+		addSlab(slotsPerSlab);
+
+	void *slot = freeSlots;
+	freeSlots = *static_cast<void **>(slot);
+	++used;
+	return slot;
+}
+
+void ObjectPool::release(void *slot)
+{
+	*static_cast<void **>(slot) = freeSlots;
+	freeSlots = slot;
+	--used;
+}
+
+void ObjectPool::reserve(size_t count)
+{
+	if (count > capacity)
+		addSlab(count - capacity);
+}
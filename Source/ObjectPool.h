@@ -0,0 +1,53 @@
+//==============================================================================
+/*!
+\file		ObjectPool.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the fixed size slab allocator
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// hands out memory for objects of up to one size from slabs that are never given back until the pool goes away.
+// freed slots are kept in a list threaded through the slots themselves, so reuse is a pop and nothing is allocated
+// once the pool has grown to the most objects alive at once. the pool only deals in memory, the caller constructs
+// into a slot and destroys before releasing it
+class ObjectPool
+{
+	size_t slotSize{};
+	size_t slotsPerSlab{};
+	std::vector<std::unique_ptr<std::max_align_t[]>> slabs;
+	void *freeSlots{ nullptr };		// first free slot, each free slot starts with the next one
+	size_t used{};
+	size_t capacity{};
+
+	void addSlab(size_t slots);
+
+public:
+
+	// @param objectSize: largest object the slots have to fit
+	// @param slotsPerSlab: slots added whenever the pool runs out
+	ObjectPool(size_t objectSize = sizeof(void *), size_t slotsPerSlab = 256);
+
+	void *allocate();
+	void release(void *slot);
+
+	//! grows the pool so count objects fit without another slab
+	void reserve(size_t count);
+
+	size_t getUsed() const { return used; }
+	size_t getCapacity() const { return capacity; }
+	size_t getBytes() const { return capacity * slotSize; }
+};
+
+#endif // !OBJECTPOOL_H
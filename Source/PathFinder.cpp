@@ -0,0 +1,342 @@
+//==============================================================================
+/*!
+\file		PathFinder.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the point to point path searches (A*, JPS, JPS+)
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "PathFinder.h"
+#include "FieldSolver.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+	// row/ col step of each direction, clockwise from north. diagonals are the odd ones
+	constexpr int DIR_ROW[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+	constexpr int DIR_COL[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+	int sign(int value) { return (value > 0) - (value < 0); }
+
+	//! direction of a step (-1 to 1 in rows and cols), -1 for no step
+	int dirOf(int i, int j)
+	{
+		constexpr int DIRS[9] = { 7, 0, 1, 6, -1, 2, 5, 4, 3 };
+		return DIRS[(i + 1) * 3 + j + 1];
+	}
+
+	//! direction of the line from one cell to another
+	int dirTo(int from, int to, int width)
+	{
+		return dirOf(sign(to / width - from / width), sign(to % width - from % width));
+	}
+
+	//! cost of the shortest 8 neighbour path between two cells without walls
+	float octile(int from, int to, int width)
+	{
+		int rows = std::abs(to / width - from / width), cols = std::abs(to % width - from % width);
+		return std::min(rows, cols) * DIAG_COST + std::abs(rows - cols) * ORTH_COST;
+	}
+}
+
+void PathFinder::buildJumpTable(int _height, int _width, std::vector<unsigned char> const &_walls)
+{
+	height = tableHeight = _height;
+	width = tableWidth = _width;
+	walls = _walls.data();
+	jumps.assign(static_cast<size_t>(height) * width * 8, 0);
+
+	// every entry is made from the entry of the cell after it, so the rows and columns are swept
+	// against the direction. the straight directions go first since the diagonals read them
+	for (int pass{}; pass < 2; ++pass)
+		for (int dir{ pass }; dir < 8; dir += 2)
+			for (int r{}; r < height; ++r)
+			{
+				int row = DIR_ROW[dir] > 0 ? height - 1 - r : r;
+
+				for (int c{}; c < width; ++c)
+				{
+					int col = DIR_COL[dir] > 0 ? width - 1 - c : c;
+					jumps[(row * width + col) * 8 + dir] = static_cast<std::int16_t>(scanJump(row, col, dir));
+				}
+			}
+}
+
+void PathFinder::patchJumpTable(int _height, int _width, std::vector<unsigned char> const &_walls, int cell)
+{
+	if (!hasJumpTable(_height, _width))
+		return;
+
+	height = _height;
+	width = _width;
+	walls = _walls.data();
+
+	int row = cell / width, col = cell % width;
+
+	// every entry only reads the walls next to its cell, so the ones that read the changed cell are around it
+	patchEntries.clear();
+
+	for (int r{ std::max(row - 1, 0) }; r <= std::min(row + 1, height - 1); ++r)
+		for (int c{ std::max(col - 1, 0) }; c <= std::min(col + 1, width - 1); ++c)
+			for (int dir{}; dir < 8; ++dir)
+				patchEntries.push_back((r * width + c) * 8 + dir);
+
+	while (!patchEntries.empty())
+	{
+		int entry = patchEntries.back();
+		patchEntries.pop_back();
+
+		int index = entry / 8, dir = entry % 8;
+		int value = scanJump(index / width, index % width, dir);
+
+		if (value == jumps[entry])
+			continue;
+
+		jumps[entry] = static_cast<std::int16_t>(value);
+
+		// the cell before it in the same direction reads it, and for a straight entry
+		// so do the cells behind it on the two diagonals it is a part of
+		for (int reader : { dir, (dir + 7) % 8, (dir + 1) % 8 })
+		{
+			if (reader != dir && dir % 2)
+				break;
+
+			int r = index / width - DIR_ROW[reader], c = index % width - DIR_COL[reader];
+
+			if (r >= 0 && r < height && c >= 0 && c < width)
+				patchEntries.push_back((r * width + c) * 8 + reader);
+		}
+	}
+}
+
+void PathFinder::setJumpTable(int _height, int _width, std::vector<std::int16_t> const &table)
+{
+	if (table.size() != static_cast<size_t>(_height) * _width * 8)
+	{
+		jumps.clear();
+		return;
+	}
+
+	jumps = table;
+	tableHeight = _height;
+	tableWidth = _width;
+}
+
+bool PathFinder::hasJumpTable(int _height, int _width) const
+{
+	return !jumps.empty() && tableHeight == _height && tableWidth == _width;
+}
+
+bool PathFinder::findPath(int _height, int _width, std::vector<unsigned char> const &_walls, int start, int _goal, PathMethod method, std::vector<int> &path)
+{
+	height = _height;
+	width = _width;
+	walls = _walls.data();
+	goal = _goal;
+	expanded = 0;
+	path.clear();
+
+	int count = height * width;
+
+	if (start < 0 || start >= count || goal < 0 || goal >= count || walls[start] || walls[goal])
+		return false;
+
+	if (method == PathMethod::JPS_PLUS && !hasJumpTable(height, width))
+		method = PathMethod::JPS;
+
+	// nodes from older searches are told apart by their generation instead of being cleared
+	if (nodes.size() != static_cast<size_t>(count) || ++generation == 0)
+	{
+		nodes.assign(count, Node{});
+		generation = 1;
+	}
+
+	open = {};
+	relax(start, 0.f, -1);
+
+	while (!open.empty())
+	{
+		int cell = open.top().second;
+		open.pop();
+
+		Node &node = nodes[cell];
+
+		if (node.isClosed)
+			continue;
+
+		node.isClosed = true;
+		++expanded;
+
+		if (cell == goal)
+		{
+			buildPath(path);
+			return true;
+		}
+
+		int row = cell / width, col = cell % width;
+		int first{}, last{ 7 };
+
+		// past the start a jump only goes on in the direction it came from, to the diagonals next to it and, for a
+		// straight jump, to the sides its forced neighbours are on. A* looks at every neighbour
+		if (method != PathMethod::ASTAR && node.parent >= 0)
+		{
+			int from = dirTo(node.parent, cell, width);
+			int spread = from % 2 ? 1 : 2;
+			first = from - spread;
+			last = from + spread;
+		}
+
+		for (int turn{ first }; turn <= last; ++turn)
+		{
+			int dir = (turn + 8) % 8;
+			int next{ -1 };
+
+			switch (method)
+			{
+			case PathMethod::ASTAR:
+				if (canStep(row, col, dir))
+					next = cell + DIR_ROW[dir] * width + DIR_COL[dir];
+				break;
+
+			case PathMethod::JPS:
+				next = jump(row, col, dir);
+				break;
+
+			case PathMethod::JPS_PLUS:
+				next = jumpPlus(row, col, dir);
+				break;
+			}
+
+			// every jump is a straight or diagonal line, so it costs the octile distance
+			if (next >= 0)
+				relax(next, node.dist + octile(cell, next, width), cell);
+		}
+	}
+
+	return false;
+}
+
+bool PathFinder::isOpen(int row, int col) const
+{
+	return row >= 0 && row < height && col >= 0 && col < width && !walls[row * width + col];
+}
+
+bool PathFinder::canStep(int row, int col, int dir) const
+{
+	int i = DIR_ROW[dir], j = DIR_COL[dir];
+
+	// diagonal steps don't squeeze past walls
+	return isOpen(row + i, col + j) && (!i || !j || (isOpen(row + i, col) && isOpen(row, col + j)));
+}
+
+bool PathFinder::isForced(int row, int col, int dir) const
+{
+	int i = DIR_ROW[dir], j = DIR_COL[dir];
+
+	// a side cell that could not be reached diagonally from the cell before has to go through this one
+	if (!i)
+		return (isOpen(row - 1, col) && !isOpen(row - 1, col - j)) || (isOpen(row + 1, col) && !isOpen(row + 1, col - j));
+
+	return (isOpen(row, col - 1) && !isOpen(row - i, col - 1)) || (isOpen(row, col + 1) && !isOpen(row - i, col + 1));
+}
+
+float PathFinder::estimate(int cell) const
+{
+	return octile(cell, goal, width);
+}
+
+int PathFinder::jump(int row, int col, int dir) const
+{
+	while (canStep(row, col, dir))
+	{
+		row += DIR_ROW[dir];
+		col += DIR_COL[dir];
+
+		int cell = row * width + col;
+
+		if (cell == goal)
+			return cell;
+
+		// diagonal jumps stop where one of their straight parts finds something
+		if (dir % 2 ? jump(row, col, dir - 1) >= 0 || jump(row, col, (dir + 1) % 8) >= 0 : isForced(row, col, dir))
+			return cell;
+	}
+
+	return -1;
+}
+
+int PathFinder::jumpPlus(int row, int col, int dir) const
+{
+	int i = DIR_ROW[dir], j = DIR_COL[dir];
+	int cell = row * width + col;
+	int dist = jumps[cell * 8 + dir];
+	int reach = std::abs(dist);
+	int rows = goal / width - row, cols = goal % width - col;
+
+	// the table doesn't know the goal, so the jump also stops at it, or for a diagonal at the cell lined up with it
+	if (dir % 2)
+	{
+		int steps = std::min(std::abs(rows), std::abs(cols));
+
+		if (sign(rows) == i && sign(cols) == j && steps <= reach)
+			return cell + steps * (i * width + j);
+	}
+	else if ((i ? !cols && sign(rows) == i : !rows && sign(cols) == j) && std::abs(rows + cols) <= reach)
+		return goal;
+
+	return dist > 0 ? cell + dist * (i * width + j) : -1;
+}
+
+int PathFinder::scanJump(int row, int col, int dir) const
+{
+	if (!canStep(row, col, dir))
+		return 0;
+
+	int i = DIR_ROW[dir], j = DIR_COL[dir];
+	int next = (row + i) * width + col + j;
+	bool isJumpPoint = dir % 2 ? jumps[next * 8 + dir - 1] > 0 || jumps[next * 8 + (dir + 1) % 8] > 0 : isForced(row + i, col + j, dir);
+
+	if (isJumpPoint)
+		return 1;
+
+	int dist = jumps[next * 8 + dir];
+	return dist > 0 ? dist + 1 : dist - 1;
+}
+
+void PathFinder::relax(int cell, float dist, int parent)
+{
+	Node &node = nodes[cell];
+
+	if (node.generation == generation && (node.isClosed || dist >= node.dist))
+		return;
+
+	node = Node{ dist, parent, generation, false };
+	open.push({ dist + estimate(cell), cell });
+}
+
+void PathFinder::buildPath(std::vector<int> &path) const
+{
+	for (int cell{ goal }; cell >= 0; cell = nodes[cell].parent)
+		path.push_back(cell);
+
+	std::reverse(path.begin(), path.end());
+
+	if (path.size() < 2)
+		return;
+
+	// drop the cells the path goes straight through, A* has all of them and jump points can line up
+	size_t kept{ 1 };
+
+	for (size_t i{ 1 }; i + 1 < path.size(); ++i)
+		if (dirTo(path[kept - 1], path[i], width) != dirTo(path[i], path[i + 1], width))
+			path[kept++] = path[i];
+
+	path[kept++] = path.back();
+	path.resize(kept);
+}
@@ -0,0 +1,104 @@
+//==============================================================================
+/*!
+\file		PathFinder.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the point to point path searches (A*, JPS, JPS+)
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+enum class PathMethod { ASTAR, JPS, JPS_PLUS };
+
+// shortest path between two cells of a wall layer, with the same steps as the heat maps: 8 neighbours,
+// octile costs and no diagonal squeezing past a wall. jump point search only expands the cells where
+// the path may have to turn, and JPS+ reads how far each jump goes from a table built once per map
+class PathFinder
+{
+public:
+
+	// @brief rebuilds the JPS+ jump distances of every cell in the 8 directions
+	// @note distances are stored in 16 bits, maps up to 32767 cells across
+	void buildJumpTable(int height, int width, std::vector<unsigned char> const &walls);
+
+	// @brief brings the jump table up to date after one cell became a wall or opened up. only the entries that read
+	//        the cell are recomputed, and the ones before them along their row, column or diagonal while they keep changing
+	// @param walls: with the cell already changed. no-op without a jump table for the map
+	void patchJumpTable(int height, int width, std::vector<unsigned char> const &walls, int cell);
+
+	//! takes a jump table built for a map of this size (loaded with the map), a table of the wrong size is dropped
+	void setJumpTable(int height, int width, std::vector<std::int16_t> const &table);
+
+	//! jump distances of the last built, patched or set table, 8 per cell
+	std::vector<std::int16_t> const &getJumpTable() const { return jumps; }
+
+	//! whether there is a jump table for a map of this size
+	bool hasJumpTable(int height, int width) const;
+
+	// @brief shortest path from start to goal (cell indices), JPS+ falls back to JPS without a jump table for the map
+	// @param path: the cells the path turns in, start first and goal last. empty when there is no path
+	// @return false if the goal can not be reached
+	bool findPath(int height, int width, std::vector<unsigned char> const &walls, int start, int goal, PathMethod method, std::vector<int> &path);
+
+	//! cells taken off the open list by the last search
+	size_t getExpanded() const { return expanded; }
+
+private:
+
+	// search state of a cell, valid when its generation is the current one
+	struct Node
+	{
+		float dist{};
+		int parent{ -1 };
+		unsigned generation{};
+		bool isClosed{ false };
+	};
+
+	using OpenEntry = std::pair<float, int>;	// estimated total cost, cell
+
+	// map being searched
+	int height{}, width{};
+	unsigned char const *walls{};
+	int goal{ -1 };
+
+	std::vector<Node> nodes;
+	unsigned generation{};
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+	size_t expanded{};
+
+	// jump distances, 8 per cell in direction order. positive: steps to the next jump point,
+	// otherwise minus the steps that can be taken before a wall or the edge
+	std::vector<std::int16_t> jumps;
+	int tableHeight{}, tableWidth{};
+	std::vector<int> patchEntries;		// scratch stack of entries (cell * 8 + direction) to recompute
+
+	bool isOpen(int row, int col) const;
+	bool canStep(int row, int col, int dir) const;
+	bool isForced(int row, int col, int dir) const;
+	float estimate(int cell) const;
+
+	//! next jump point from a cell in a direction, the goal counts as one. -1 if the jump runs into a wall
+	int jump(int row, int col, int dir) const;
+	//! same as jump but read from the table
+	int jumpPlus(int row, int col, int dir) const;
+	//! jump table entry of a cell from the entry of the cell after it
+	int scanJump(int row, int col, int dir) const;
+
+	void relax(int cell, float dist, int parent);
+	void buildPath(std::vector<int> &path) const;
+};
+
+#endif // !PATHFINDER_H
@@ -0,0 +1,547 @@
+//==============================================================================
+/*!
+\file		SectorFlowField.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the hierarchical (sector and portal) flow field
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "SectorFlowField.h"
+#include <algorithm>
+
+// =====
+// SETUP
+// =====
+
+void SectorFlowField::reset(int _height, int _width, std::vector<unsigned char> &&_blocked)
+{
+	height = _height;
+	width = _width;
+	blocked = std::move(_blocked);
+
+	sectorRows = (height + SECTOR_SIZE - 1) / SECTOR_SIZE;
+	sectorCols = (width + SECTOR_SIZE - 1) / SECTOR_SIZE;
+	sectors.assign(sectorRows * sectorCols, Sector{});
+
+	for (int row{}; row < sectorRows; ++row)
+		for (int col{}; col < sectorCols; ++col)
+			sectors[row * sectorCols + col].bounds = { row * SECTOR_SIZE, col * SECTOR_SIZE,
+				std::min(height, (row + 1) * SECTOR_SIZE), std::min(width, (col + 1) * SECTOR_SIZE) };
+
+	goal = -1;
+	isSearchStale = true;
+}
+
+void SectorFlowField::setBlocked(int index, bool isBlocked)
+{
+	if (index < 0 || index >= static_cast<int>(blocked.size()) || blocked[index] == isBlocked)
+		return;
+
+	blocked[index] = isBlocked;
+	isSearchStale = true;
+
+	int row = index / width, col = index % width;
+	int sectorRow = row / SECTOR_SIZE, sectorCol = col / SECTOR_SIZE;
+
+	sectors[getSector(index)].isDirty = true;
+
+	// a border cell also changes the portals of the sector across
+	if (row % SECTOR_SIZE == 0 && sectorRow > 0)
+		sectors[(sectorRow - 1) * sectorCols + sectorCol].isDirty = true;
+	if (row % SECTOR_SIZE == SECTOR_SIZE - 1 && sectorRow + 1 < sectorRows)
+		sectors[(sectorRow + 1) * sectorCols + sectorCol].isDirty = true;
+	if (col % SECTOR_SIZE == 0 && sectorCol > 0)
+		sectors[sectorRow * sectorCols + sectorCol - 1].isDirty = true;
+	if (col % SECTOR_SIZE == SECTOR_SIZE - 1 && sectorCol + 1 < sectorCols)
+		sectors[sectorRow * sectorCols + sectorCol + 1].isDirty = true;
+}
+
+void SectorFlowField::setGoal(int row, int col)
+{
+	int index = row < 0 || col < 0 || row >= height || col >= width ? -1 : row * width + col;
+
+	if (index == goal)
+		return;
+
+	goal = index;
+	isSearchStale = true;
+}
+
+int SectorFlowField::getSector(int cell) const
+{
+	return cell / width / SECTOR_SIZE * sectorCols + cell % width / SECTOR_SIZE;
+}
+
+// =======
+// SECTORS
+// =======
+
+void SectorFlowField::findEntrances(Sector &sector) const
+{
+	TileBounds const &b = sector.bounds;
+	sector.entrances.clear();
+
+	// walks one border, (row, col) + k * step inside and the same + across outside
+	auto scan = [&](int row, int col, int stepRow, int stepCol, int length, int across)
+		{
+			int runStart = -1;
+
+			for (int k{}; k <= length; ++k)
+			{
+				int cell = (row + k * stepRow) * width + col + k * stepCol;
+				bool isOpen = k < length && !blocked[cell] && !blocked[cell + across];
+
+				if (isOpen && runStart < 0)
+					runStart = k;
+
+				if (!isOpen && runStart >= 0)
+				{
+					// both sectors pick the middle of the run, so their entrances face each other
+					int middle = (runStart + k - 1) / 2;
+					int entrance = (row + middle * stepRow) * width + col + middle * stepCol;
+					sector.entrances.push_back({ entrance, entrance + across, 0 });
+					runStart = -1;
+				}
+			}
+		};
+
+	int rows = b.row1 - b.row0, cols = b.col1 - b.col0;
+
+	if (b.row0 > 0)
+		scan(b.row0, b.col0, 0, 1, cols, -width);
+	if (b.row1 < height)
+		scan(b.row1 - 1, b.col0, 0, 1, cols, width);
+	if (b.col0 > 0)
+		scan(b.row0, b.col0, 1, 0, rows, -1);
+	if (b.col1 < width)
+		scan(b.row0, b.col1 - 1, 1, 0, rows, 1);
+}
+
+SectorFlowField::Sector &SectorFlowField::prepare(int index)
+{
+	Sector &sector = sectors[index];
+
+	if (!sector.isDirty)
+		return sector;
+
+	findEntrances(sector);
+
+	loadLocal(sector);
+	sector.componentCount = labelLocal(sector);
+	for (Entrance &entrance : sector.entrances)
+		entrance.component = localLabels[getLocal(sector, entrance.cell)];
+
+	size_t count = sector.entrances.size();
+	sector.costs.assign(count * count, UNREACHED);
+	sector.hasCosts.assign(count, false);
+	sector.isDirty = false;
+	return sector;
+}
+
+float const *SectorFlowField::getCosts(Sector &sector, size_t from)
+{
+	size_t count = sector.entrances.size();
+	float *costs = sector.costs.data() + from * count;
+
+	if (sector.hasCosts[from])
+		return costs;
+
+	// one solve from the entrance gives its row of the cost matrix
+	loadLocal(sector);
+	seeds.assign(1, { sector.entrances[from].cell, 0.f });
+	solveLocal(sector);
+
+	for (size_t to{}; to < count; ++to)
+		costs[to] = localDist[getLocal(sector, sector.entrances[to].cell)];
+
+	sector.hasCosts[from] = true;
+	return costs;
+}
+
+void SectorFlowField::loadLocal(Sector const &sector)
+{
+	TileBounds const &b = sector.bounds;
+	int cols = b.col1 - b.col0;
+
+	localBlocked.resize((b.row1 - b.row0) * cols);
+	localCanEnter.resize(localBlocked.size());
+
+	for (int row{ b.row0 }; row < b.row1; ++row)
+		for (int col{ b.col0 }; col < b.col1; ++col)
+		{
+			int local = (row - b.row0) * cols + col - b.col0;
+			localBlocked[local] = blocked[row * width + col];
+			localCanEnter[local] = !localBlocked[local];
+		}
+}
+
+void SectorFlowField::solveLocal(Sector const &sector)
+{
+	TileBounds const &b = sector.bounds;
+	int rows = b.row1 - b.row0, cols = b.col1 - b.col0;
+
+	localDist.assign(rows * cols, UNREACHED);
+
+	// keep the bucket keys small, the seeds may be far from the goal
+	float offset = UNREACHED;
+	for (auto const &[cell, dist] : seeds)
+		offset = std::min(offset, dist);
+
+	queue.clear();
+
+	for (auto const &[cell, dist] : seeds)
+	{
+		int local = getLocal(sector, cell);
+
+		if (localCanEnter[local] && dist - offset < localDist[local])
+		{
+			localDist[local] = dist - offset;
+			queue.push(localDist[local], local);
+		}
+	}
+
+	solveTile({ 0, 0, rows, cols }, cols, localCanEnter, localBlocked, localDist, nullptr, queue);
+
+	for (float &dist : localDist)
+		if (dist != UNREACHED)
+			dist += offset;
+}
+
+int SectorFlowField::labelLocal(Sector const &sector)
+{
+	int rows = sector.bounds.row1 - sector.bounds.row0, cols = sector.bounds.col1 - sector.bounds.col0;
+	int count{};
+
+	localLabels.assign(rows * cols, -1);
+
+	for (int start{}; start < rows * cols; ++start)
+	{
+		if (!localCanEnter[start] || localLabels[start] >= 0)
+			continue;
+
+		// flood the part with the same steps solveTile takes
+		localLabels[start] = count;
+		stack.assign(1, start);
+
+		while (stack.size())
+		{
+			int local = stack.back();
+			stack.pop_back();
+			int row = local / cols, col = local % cols;
+
+			for (int i{ -1 }; i <= 1; ++i)
+				for (int j{ -1 }; j <= 1; ++j)
+				{
+					if (row + i < 0 || row + i >= rows || col + j < 0 || col + j >= cols)
+						continue;
+
+					int neighbour = local + i * cols + j;
+
+					if (!localCanEnter[neighbour] || localLabels[neighbour] >= 0)
+						continue;
+
+					if (i != 0 && j != 0 && (localBlocked[local + i * cols] || localBlocked[local + j]))
+						continue;
+
+					localLabels[neighbour] = count;
+					stack.push_back(neighbour);
+				}
+		}
+
+		++count;
+	}
+
+	return count;
+}
+
+int SectorFlowField::getLocal(Sector const &sector, int cell) const
+{
+	return (cell / width - sector.bounds.row0) * (sector.bounds.col1 - sector.bounds.col0) + cell % width - sector.bounds.col0;
+}
+
+// =============
+// COARSE SEARCH
+// =============
+
+void SectorFlowField::restartSearch()
+{
+	nodes.clear();
+	open = {};
+	target = -1;
+	++searchGeneration;
+	solvedSectors = 0;
+	isSearchStale = false;
+
+	if (goal < 0 || blocked[goal])
+		return;
+
+	findReachable();
+	relax(goal, 0.f, -1);
+}
+
+void SectorFlowField::findReachable()
+{
+	// only a flood fill per changed sector, no distances
+	int components{};
+
+	for (int index{}; index < static_cast<int>(sectors.size()); ++index)
+	{
+		Sector &sector = prepare(index);
+		sector.firstComponent = components;
+		components += sector.componentCount;
+	}
+
+	isReachable.assign(components, false);
+
+	Sector const &goalSector = sectors[getSector(goal)];
+	loadLocal(goalSector);
+	labelLocal(goalSector);
+
+	int start = goalSector.firstComponent + localLabels[getLocal(goalSector, goal)];
+	isReachable[start] = true;
+	stack.assign(1, start);
+
+	// sector parts are linked by the portals between their entrances
+	while (stack.size())
+	{
+		int component = stack.back();
+		stack.pop_back();
+
+		int index = static_cast<int>(std::upper_bound(sectors.begin(), sectors.end(), component,
+			[](int value, Sector const &sector) { return value < sector.firstComponent; }) - sectors.begin()) - 1;
+		Sector const &sector = sectors[index];
+
+		for (Entrance const &entrance : sector.entrances)
+		{
+			if (sector.firstComponent + entrance.component != component)
+				continue;
+
+			Sector const &across = sectors[getSector(entrance.partner)];
+
+			for (Entrance const &other : across.entrances)
+				if (other.cell == entrance.partner && !isReachable[across.firstComponent + other.component])
+				{
+					isReachable[across.firstComponent + other.component] = true;
+					stack.push_back(across.firstComponent + other.component);
+				}
+		}
+	}
+}
+
+void SectorFlowField::relax(int cell, float dist, int parent)
+{
+	Node &node = nodes[cell];
+
+	if (node.isSettled || dist >= node.dist)
+		return;
+
+	node.dist = dist;
+	node.parent = parent;
+	open.push({ dist + estimate(cell), cell });
+}
+
+float SectorFlowField::estimate(int cell) const
+{
+	if (target < 0)
+		return 0.f;
+
+	// octile distance to the closest cell of the target sector, never more than any path there
+	TileBounds const &b = sectors[target].bounds;
+	int row = cell / width, col = cell % width;
+	int dr = std::max({ b.row0 - row, row - b.row1 + 1, 0 });
+	int dc = std::max({ b.col0 - col, col - b.col1 + 1, 0 });
+
+	return ORTH_COST * std::abs(dr - dc) + DIAG_COST * std::min(dr, dc);
+}
+
+void SectorFlowField::setTarget(int index)
+{
+	if (index == target)
+		return;
+
+	target = index;
+
+	// the settled distances stay exact under any consistent estimate, only the open list is keyed again
+	open = {};
+	for (auto const &[cell, node] : nodes)
+		if (!node.isSettled && node.dist != UNREACHED)
+			open.push({ node.dist + estimate(cell), cell });
+}
+
+bool SectorFlowField::settleNext()
+{
+	while (!open.empty())
+	{
+		auto [key, cell] = open.top();
+		open.pop();
+
+		Node &node = nodes[cell];
+
+		// skip entries that were improved since
+		if (node.isSettled || key != node.dist + estimate(cell))
+			continue;
+
+		node.isSettled = true;
+		float dist = node.dist;
+		Sector &sector = prepare(getSector(cell));
+		size_t count = sector.entrances.size();
+
+		if (cell == goal)
+		{
+			// the goal is not an entrance (or not only one), solve its own row
+			loadLocal(sector);
+			seeds.assign(1, { goal, 0.f });
+			solveLocal(sector);
+
+			for (Entrance const &entrance : sector.entrances)
+			{
+				float cost = localDist[getLocal(sector, entrance.cell)];
+				if (cost != UNREACHED)
+					relax(entrance.cell, cost, goal);
+			}
+		}
+		else
+		{
+			auto from = std::find_if(sector.entrances.begin(), sector.entrances.end(),
+				[cell](Entrance const &entrance) { return entrance.cell == cell; });
+
+			if (from != sector.entrances.end())
+			{
+				float const *costs = getCosts(sector, from - sector.entrances.begin());
+
+				for (size_t to{}; to < count; ++to)
+					if (costs[to] != UNREACHED)
+						relax(sector.entrances[to].cell, dist + costs[to], cell);
+			}
+		}
+
+		// through the portals, a corner cell can face two sectors
+		for (Entrance const &entrance : sector.entrances)
+			if (entrance.cell == cell)
+				relax(entrance.partner, dist + ORTH_COST, cell);
+
+		return true;
+	}
+
+	return false;
+}
+
+bool SectorFlowField::isResolved(Sector const &sector) const
+{
+	for (Entrance const &entrance : sector.entrances)
+	{
+		if (!isReachable[sector.firstComponent + entrance.component])
+			continue;
+
+		auto node = nodes.find(entrance.cell);
+		if (node == nodes.end() || !node->second.isSettled)
+			return false;
+	}
+
+	return true;
+}
+
+void SectorFlowField::resolve(int index)
+{
+	Sector &sector = prepare(index);
+	setTarget(index);
+
+	// entrances cut off from the goal are skipped, the search would have to run out to find them
+	while (!isResolved(sector) && settleNext());
+}
+
+// =========
+// DIRECTION
+// =========
+
+Vec2 SectorFlowField::getDirection(int row, int col)
+{
+	if (row < 0 || col < 0 || row >= height || col >= width || static_cast<int>(blocked.size()) != height * width)
+		return {};
+
+	if (isSearchStale)
+		restartSearch();
+
+	int cell = row * width + col;
+
+	if (goal < 0 || cell == goal || blocked[cell])
+		return {};
+
+	int index = getSector(cell);
+	Sector &sector = sectors[index];
+	TileBounds const &b = sector.bounds;
+
+	if (sector.fieldGeneration != searchGeneration)
+	{
+		resolve(index);
+
+		// every settled entrance is a source at its distance to the goal
+		seeds.clear();
+		if (getSector(goal) == index)
+			seeds.push_back({ goal, 0.f });
+
+		for (Entrance const &entrance : sector.entrances)
+		{
+			auto node = nodes.find(entrance.cell);
+			if (node != nodes.end() && node->second.isSettled)
+				seeds.push_back({ entrance.cell, node->second.dist });
+		}
+
+		loadLocal(sector);
+		solveLocal(sector);
+		sector.field.swap(localDist);
+		sector.fieldGeneration = searchGeneration;
+		++solvedSectors;
+	}
+
+	int cols = b.col1 - b.col0;
+	int local = getLocal(sector, cell);
+
+	if (sector.field[local] == UNREACHED)
+		return {};
+
+	// an entrance reached through its portal steps across it
+	auto node = nodes.find(cell);
+	if (node != nodes.end() && node->second.isSettled && node->second.parent >= 0 && getSector(node->second.parent) != index)
+		return Vec2(static_cast<float>(node->second.parent % width - col), static_cast<float>(node->second.parent / width - row));
+
+	// otherwise follow the neighbour the distance came from
+	float best = UNREACHED;
+	Vec2 step{};
+
+	for (int i{ -1 }; i <= 1; ++i)
+	{
+		if (row + i < b.row0 || row + i >= b.row1)
+			continue;
+
+		for (int j{ -1 }; j <= 1; ++j)
+		{
+			if ((i == 0 && j == 0) || col + j < b.col0 || col + j >= b.col1)
+				continue;
+
+			int neighbour = local + i * cols + j;
+
+			if (sector.field[neighbour] == UNREACHED)
+				continue;
+
+			// skip diagonal neighbors if there's an adjacent wall
+			if (i != 0 && j != 0 && (blocked[cell + i * width] || blocked[cell + j]))
+				continue;
+
+			float dist = sector.field[neighbour] + stepCost(i, j);
+
+			if (dist < best)
+			{
+				best = dist;
+				step = Vec2(static_cast<float>(j), static_cast<float>(i));
+			}
+		}
+	}
+
+	return step;
+}
@@ -0,0 +1,139 @@
+//==============================================================================
+/*!
+\file		SectorFlowField.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the hierarchical (sector and portal) flow field
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef SECTORFLOWFIELD_H
+#define SECTORFLOWFIELD_H
+
+#include "Vector2D.h"
+#include "FieldSolver.h"
+#include <vector>
+#include <unordered_map>
+#include <queue>
+#include <utility>
+#include <functional>
+
+// flow field to one goal for large maps (Supreme Commander/ Planetary Annihilation style). the grid is split into
+// sectors, and every run of open cells along a sector border is a portal with an entrance cell on each side. an A*
+// over the entrances from the goal, aimed at the sector that is asked about, only runs until that sector's entrances
+// are settled and is picked up again for the next one. a sector gets a distance field of its own (seeded with the
+// distances of its entrances) on the first query inside it, so the work follows the corridors the agents use.
+// paths are bent through the middle of each portal, the usual price for not solving every cell
+class SectorFlowField
+{
+public:
+
+	static constexpr int SECTOR_SIZE = 16;	// rows and columns per sector
+
+	// @brief drops everything for a new or replaced map
+	// @param blocked: height * width flags of the cells that cannot be entered and block diagonal steps
+	void reset(int height, int width, std::vector<unsigned char> &&blocked);
+
+	//! a cell became blocked or open, the sectors it borders are rebuilt on the next query
+	void setBlocked(int index, bool isBlocked);
+
+	//! moves the goal, no-op if it did not move. out of bound clears it
+	void setGoal(int row, int col);
+
+	// @brief step (-1 to 1 in x and y) to take from a cell toward the goal
+	// @return zero for the goal, blocked and unreachable cells, or when there is no goal
+	Vec2 getDirection(int row, int col);
+
+	//! sectors with a distance field for the current goal and walls
+	int getSolvedSectors() const { return solvedSectors; }
+
+private:
+
+	// open cell on a sector border with an open cell right across it
+	struct Entrance
+	{
+		int cell, partner;
+		int component;					// connected part of the sector the cell is in
+	};
+
+	struct Sector
+	{
+		TileBounds bounds;
+		std::vector<Entrance> entrances;
+		std::vector<float> costs;		// entrances^2 shortest distances inside the sector
+		std::vector<bool> hasCosts;		// rows of costs solved so far
+		std::vector<float> field;		// distance to the goal of every cell, solved on the first query
+		unsigned fieldGeneration{};		// search the field was solved for
+		int componentCount{};			// connected parts of the sector
+		int firstComponent{};			// index of the first one in isReachable
+		bool isDirty{ true };			// entrances and costs are rebuilt before the next use
+	};
+
+	// coarse search state of an entrance (or the goal)
+	struct Node
+	{
+		float dist{ UNREACHED };
+		int parent{ -1 };
+		bool isSettled{ false };
+	};
+
+	using QueueEntry = std::pair<float, int>;	// distance + estimate, cell
+
+	int height{}, width{};
+	int sectorRows{}, sectorCols{};
+	std::vector<unsigned char> blocked;
+	std::vector<Sector> sectors;
+
+	int goal{ -1 };
+	int target{ -1 };				// sector the search is aimed at
+	bool isSearchStale{ true };		// goal or walls changed since the search started
+	unsigned searchGeneration{ 1 };	// bumped every time the search starts over
+	int solvedSectors{};
+
+	std::unordered_map<int, Node> nodes;	// keyed by cell
+	std::vector<unsigned char> isReachable;	// sector parts connected to the goal through the portals
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+
+	// scratch for the solves inside one sector
+	std::vector<unsigned char> localCanEnter, localBlocked;
+	std::vector<float> localDist;
+	std::vector<int> localLabels, stack;
+	std::vector<std::pair<int, float>> seeds;
+	BucketQueue queue;
+
+	int getSector(int cell) const;
+
+	//! brings the entrances of a sector up to date, the costs are solved row by row when needed
+	Sector &prepare(int index);
+	float const *getCosts(Sector &sector, size_t from);
+	void findEntrances(Sector &sector) const;
+
+	//! copies the blocked flags of a sector into the local layers
+	void loadLocal(Sector const &sector);
+	//! solves localDist inside the loaded sector from the seeds (grid cell, distance)
+	void solveLocal(Sector const &sector);
+	//! labels the connected parts of the loaded sector in localLabels, returns how many there are
+	int labelLocal(Sector const &sector);
+	int getLocal(Sector const &sector, int cell) const;
+
+	//! marks the sector parts the goal can reach, every entrance of the others is left out of the search
+	void findReachable();
+
+	void restartSearch();
+	//! lower bound of the distance from a cell to the target sector
+	float estimate(int cell) const;
+	//! aims the search at another sector
+	void setTarget(int index);
+	void relax(int cell, float dist, int parent);
+	//! settles the closest open node, false once the search ran out
+	bool settleNext();
+	//! runs the search until every entrance of a sector is settled or unreachable
+	void resolve(int index);
+	bool isResolved(Sector const &sector) const;
+};
+
+#endif // !SECTORFLOWFIELD_H
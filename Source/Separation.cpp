@@ -0,0 +1,169 @@
+//==============================================================================
+/*!
+\file		Separation.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the agent overlap resolution
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "Separation.h"
+#include <algorithm>
+#include <cmath>
+
+void AgentSeparation::resolve(std::vector<Vec2> &pos, std::vector<Vec2> const &scale, Vec2 mapSize, Vec2 const *exit, std::function<bool(Vec2)> const &isBlocked)
+{
+	int count = static_cast<int>(pos.size());
+
+	if (count < 2)
+		return;
+
+	Vec2 centroid{};
+
+	for (Vec2 const &p : pos)
+		centroid += p;
+
+	centroid /= static_cast<float>(count);
+
+	if (!useSpatialHash)
+	{
+		for (int i{}; i < count; ++i)
+			for (int j{ i + 1 }; j < count; ++j)
+				resolvePair(pos, scale, i, j, centroid, mapSize, exit, isBlocked);
+
+		return;
+	}
+
+	// cells as wide as the farthest two agents can collide from, plus half of that as slack. the hash keeps the positions
+	// it was built from while the pairs move the agents, so a query only finds the agents that stayed within slack / 2 of
+	// where they were hashed, from a position the current agent stayed within slack / 2 of. the agents that drifted further
+	// are tried by every query, and the hash is rebuilt once there are too many of them
+	float reach{};
+
+	for (Vec2 const &s : scale)
+		reach = std::max(reach, std::min(s.x, s.y));
+
+	float cellSize = reach * 1.5f;
+	float slack = (cellSize - reach) / 2.f;
+	size_t maxDrifted = static_cast<size_t>(std::sqrt(static_cast<float>(count)));
+	Vec2 queryPos{};
+
+	auto rebuild = [&]()
+		{
+			hash.build(pos, cellSize);
+			hashedPos = pos;
+			drifted.clear();
+			isDrifted.assign(count, false);
+		};
+
+	auto markDrift = [&](int index)
+		{
+			if (!isDrifted[index] && (pos[index] - hashedPos[index]).SquareLength() > slack * slack)
+			{
+				isDrifted[index] = true;
+				drifted.push_back(index);
+			}
+		};
+
+	auto collect = [&](int i, int after)
+		{
+			if (drifted.size() > maxDrifted)
+				rebuild();
+
+			candidates.clear();
+			hash.query(pos[i], [&](int j)
+				{
+					if (j > after && !isDrifted[j])
+						candidates.push_back(j);
+				});
+
+			for (int j : drifted)
+				if (j > after)
+					candidates.push_back(j);
+
+			// same order as the pair loop
+			std::sort(candidates.begin(), candidates.end());
+			queryPos = pos[i];
+		};
+
+	rebuild();
+
+	for (int i{}; i < count; ++i)
+	{
+		collect(i, i);
+
+		for (size_t k{}; k < candidates.size();)
+		{
+			int j = candidates[k];
+
+			// pushed far enough from where it looked that an agent it didn't collect may be in reach
+			if ((pos[i] - queryPos).SquareLength() > slack * slack)
+			{
+				collect(i, j - 1);
+				k = 0;
+				continue;
+			}
+
+			resolvePair(pos, scale, i, j, centroid, mapSize, exit, isBlocked);
+			markDrift(i);
+			markDrift(j);
+			++k;
+		}
+	}
+}
+
+void AgentSeparation::resolvePair(std::vector<Vec2> &pos, std::vector<Vec2> const &scale, int i, int j, Vec2 centroid, Vec2 mapSize, Vec2 const *exit,
+	std::function<bool(Vec2)> const &isBlocked) const
+{
+	Vec2 &m1 = pos[i], &m2 = pos[j];
+
+	if (exit && ((m1 - *exit).Length() < 10 || (m2 - *exit).Length() < 10))
+		return;
+
+	float lhsRadius = std::min(scale[i].x, scale[i].y) * 0.5f;
+	float rhsRadius = std::min(scale[j].x, scale[j].y) * 0.5f;
+
+	if ((m1 - m2).SquareLength() > (lhsRadius + rhsRadius) * (lhsRadius + rhsRadius))
+		return;
+
+	vec2 direction = m2 - m1;
+
+	// on top of each other, push toward the far side of the map
+	if (direction == Vec2{ 0.f, 0.f })
+		direction = Vec2{ m1.x < mapSize.x / 2.f ? mapSize.x : 0.f, m1.y < mapSize.y / 2.f ? mapSize.y : 0.f };
+
+	direction = direction.Normalize();
+
+	float requiredDistance = std::max(std::max(scale[i].x, scale[i].y), std::max(scale[j].x, scale[j].y));
+	float currentDistance = (m1 - m2).Length();
+	vec2 displacement = direction * ((requiredDistance - currentDistance) / 2.f);
+
+	// the agent in the middle of the crowd gives way less
+	float share = (m1 - centroid).SquareLength() < 200 ? 0.25f : 0.5f;
+
+	vec2 newM1Pos = m1 - displacement * share;
+	vec2 newM2Pos = m2 + displacement * share;
+
+	bool m1CollidesWithWall = isBlocked(newM1Pos);
+	bool m2CollidesWithWall = isBlocked(newM2Pos);
+
+	// the one pushed into a wall stays and the other moves by the full amount
+	if (m1CollidesWithWall)
+	{
+		newM1Pos = m1;
+		newM2Pos = m2 + displacement;
+	}
+
+	if (m2CollidesWithWall)
+	{
+		newM2Pos = m2;
+		newM1Pos = m1 - displacement;
+	}
+
+	m1 = newM1Pos;
+	m2 = newM2Pos;
+}
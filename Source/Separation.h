@@ -0,0 +1,49 @@
+//==============================================================================
+/*!
+\file		Separation.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the agent overlap resolution
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef SEPARATION_H
+#define SEPARATION_H
+
+#include "Vector2D.h"
+#include "SpatialHash.h"
+#include <vector>
+#include <functional>
+
+// pushes overlapping agents apart once per frame. pairs are resolved one after the other in index order, each
+// seeing where the pairs before it moved the agents. the spatial hash only hands over the agents near each one
+// instead of trying every pair, and still finds every pair the pair loop would
+class AgentSeparation
+{
+	SpatialHash hash;
+	std::vector<int> candidates;		// scratch list of the agents near the current one
+	std::vector<Vec2> hashedPos;		// positions the hash was last built from
+	std::vector<int> drifted;			// agents moved too far from their hashed position for a query to find them
+	std::vector<unsigned char> isDrifted;
+
+	void resolvePair(std::vector<Vec2> &pos, std::vector<Vec2> const &scale, int i, int j, Vec2 centroid, Vec2 mapSize, Vec2 const *exit,
+		std::function<bool(Vec2)> const &isBlocked) const;
+
+public:
+
+	// broad phase, off tries every pair
+	bool useSpatialHash{ true };
+
+	// @brief moves colliding agents apart
+	// @param scale: size of every agent, agents collide within the sum of half their smaller sides
+	// @param mapSize: world size of the map, agents on top of each other are pushed toward its far side
+	// @param exit: agents at the exit are left alone, nullptr if there is none
+	// @param isBlocked: whether a position is inside a wall, agents are not pushed into walls
+	void resolve(std::vector<Vec2> &pos, std::vector<Vec2> const &scale, Vec2 mapSize, Vec2 const *exit, std::function<bool(Vec2)> const &isBlocked);
+};
+
+#endif // !SEPARATION_H
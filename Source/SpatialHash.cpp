@@ -0,0 +1,48 @@
+//==============================================================================
+/*!
+\file		SpatialHash.cpp
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Definition of the uniform grid spatial hash
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#include "SpatialHash.h"
+
+void SpatialHash::build(std::vector<Vec2> const &points, float _cellSize)
+{
+	cellSize = _cellSize > 0.f ? _cellSize : 1.f;
+
+	// about two buckets per point keeps the buckets short without many empty ones to skip
+	size_t buckets{ 1 };
+	while (buckets < points.size() * 2)
+		buckets <<= 1;
+
+	mask = buckets - 1;
+	bucketStart.assign(buckets + 1, 0);
+	pointBucket.resize(points.size());
+
+	for (size_t i{}; i < points.size(); ++i)
+	{
+		pointBucket[i] = bucketOf(cellOf(points[i].x), cellOf(points[i].y));
+		++bucketStart[pointBucket[i] + 1];
+	}
+
+	for (size_t bucket{}; bucket < buckets; ++bucket)
+		bucketStart[bucket + 1] += bucketStart[bucket];
+
+	// bucketStart[b] is used as the write cursor of bucket b and ends up at the start of b + 1, so shift it back after
+	entries.resize(points.size());
+
+	for (size_t i{}; i < points.size(); ++i)
+		entries[bucketStart[pointBucket[i]]++] = static_cast<int>(i);
+
+	for (size_t bucket{ buckets }; bucket > 0; --bucket)
+		bucketStart[bucket] = bucketStart[bucket - 1];
+
+	bucketStart[0] = 0;
+}
@@ -0,0 +1,74 @@
+//==============================================================================
+/*!
+\file		SpatialHash.h
+\project		CS380/CS580 Group Project
+\Team		wo AI ni
+\summary		Declaration of the uniform grid spatial hash
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior
+written consent of DigiPen Institute of Technology is prohibited.
+*/
+//==============================================================================
+
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include "Vector2D.h"
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+// broad phase for points that move every frame. the plane is cut into square cells that are hashed into a
+// fixed number of buckets, and the points are counting sorted by bucket on every build, so a build is two
+// passes over the points and a query only touches the buckets of the 3x3 cells around a position
+class SpatialHash
+{
+	float cellSize{ 1.f };
+	size_t mask{};						// buckets - 1, a power of two minus one
+	std::vector<int> bucketStart;		// bucket b holds entries [bucketStart[b], bucketStart[b + 1])
+	std::vector<int> entries;			// point indices sorted by bucket
+	std::vector<size_t> pointBucket;	// scratch bucket of every point
+
+	int cellOf(float coord) const { return static_cast<int>(std::floor(coord / cellSize)); }
+	size_t bucketOf(int x, int y) const { return (static_cast<size_t>(x) * 73856093u ^ static_cast<size_t>(y) * 19349663u) & mask; }
+
+public:
+
+	// @brief sorts the points into their cells
+	// @param cellSize: at least the distance that queries look for, so everything in range is in the 3x3 cells
+	void build(std::vector<Vec2> const &points, float cellSize);
+
+	// @brief calls visit(index) once for every point in the 3x3 cells around pos. cells that share a bucket
+	//        hand over each other's points too, so the caller still checks the distance
+	template <typename Func>
+	void query(Vec2 pos, Func visit) const
+	{
+		if (entries.empty())
+			return;
+
+		int x = cellOf(pos.x), y = cellOf(pos.y);
+		size_t visited[9];
+		int visitedCount{};
+
+		for (int i{ -1 }; i <= 1; ++i)
+			for (int j{ -1 }; j <= 1; ++j)
+			{
+				size_t bucket = bucketOf(x + j, y + i);
+				bool isRepeat{ false };
+
+				for (int k{}; k < visitedCount; ++k)
+					isRepeat |= visited[k] == bucket;
+
+				if (isRepeat)
+					continue;
+
+				visited[visitedCount++] = bucket;
+
+				for (int entry{ bucketStart[bucket] }; entry < bucketStart[bucket + 1]; ++entry)
+					visit(entries[entry]);
+			}
+	}
+};
+
+#endif // !SPATIALHASH_H